@@ -0,0 +1,70 @@
+#include <stdio.h>
+
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <SezaFormat.h>
+
+/* This benchmark compares the shortest round-trip float formatting against the former 
+   std::ostream with setprecision(20) path */
+
+template<typename Float>
+static std::vector<Float> randomValues(size_t count)
+{
+    std::mt19937 generator(12345);
+    std::uniform_real_distribution<Float> distribution(-1000, 1000);
+
+    std::vector<Float> values(count);
+    for(size_t i = 0; i < count; ++i)
+        values[i] = distribution(generator);
+    return values;
+}
+
+template<typename Float>
+static void benchStream(const char* name, const std::vector<Float>& values)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::ostringstream os;
+    for(size_t i = 0; i < values.size(); ++i)
+        os << std::boolalpha << std::setprecision(20) << values[i] << ',';
+
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("%-28s %8.1f ns/value %8.2f bytes/value\n", name, elapsed / values.size(), (double)os.str().size() / values.size());
+}
+
+template<typename Float>
+static void benchShortest(const char* name, const std::vector<Float>& values)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::string output;
+    output.reserve(values.size() * Seza::maxFloatLength);
+    char buffer[Seza::maxFloatLength];
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+        output.append(buffer, Seza::formatFloat(buffer, values[i]) - buffer);
+        output.push_back(',');
+    }
+
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("%-28s %8.1f ns/value %8.2f bytes/value\n", name, elapsed / values.size(), (double)output.size() / values.size());
+}
+
+int main()
+{
+    static const size_t count = 1000000;
+
+    std::vector<float> floats = randomValues<float>(count);
+    std::vector<double> doubles = randomValues<double>(count);
+
+    benchStream("float  ostream precision 20", floats);
+    benchShortest("float  shortest", floats);
+    benchStream("double ostream precision 20", doubles);
+    benchShortest("double shortest", doubles);
+
+    return 0;
+}
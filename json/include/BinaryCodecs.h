@@ -0,0 +1,614 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "Seza.h"
+#include "BinaryDefinitions.h"
+
+// Binary number codecs
+/** Encodings of the vectors of numbers declared with ADD_MEMBER_CODEC. Elements are handled as 
+64 bits values, integers sign or zero extended and floats as their bits, in blocks. The zigzag, 
+delta and one byte varint transforms take two values at a time with SSE2; the bit packing of the 
+frame of reference and XOR codecs is serial **/
+namespace Binary
+{
+    static const size_t codecBlockSize = 128;
+
+    /* -- BITS -- */
+
+    inline unsigned int countLeadingZeros(uint64_t value)
+    {
+#if defined(__GNUC__)
+        return value ? (unsigned int)__builtin_clzll(value) : 64;
+#else
+        unsigned int count = 0;
+        for(uint64_t bit = (uint64_t)1 << 63; bit && !(value & bit); bit >>= 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    inline unsigned int countTrailingZeros(uint64_t value)
+    {
+#if defined(__GNUC__)
+        return value ? (unsigned int)__builtin_ctzll(value) : 64;
+#else
+        unsigned int count = 0;
+        for(; count < 64 && !(value & ((uint64_t)1 << count)); ++count);
+        return count;
+#endif
+    }
+
+    inline uint64_t zigzag(uint64_t value) { return (value << 1) ^ (uint64_t)((int64_t)value >> 63); }
+    inline uint64_t unzigzag(uint64_t value) { return (value >> 1) ^ (0 - (value & 1)); }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    /** SSE2 has no 64 bits arithmetic shift: the sign is spread from the high half of each value **/
+    inline __m128i zigzag(__m128i value)
+    {
+        __m128i sign = _mm_shuffle_epi32(_mm_srai_epi32(value, 31), _MM_SHUFFLE(3, 3, 1, 1));
+        return _mm_xor_si128(_mm_slli_epi64(value, 1), sign);
+    }
+    inline __m128i unzigzag(__m128i value)
+    {
+        __m128i sign = _mm_sub_epi64(_mm_setzero_si128(), _mm_and_si128(value, _mm_set1_epi64x(1)));
+        return _mm_xor_si128(_mm_srli_epi64(value, 1), sign);
+    }
+#endif
+
+    inline void zigzag(uint64_t* values, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        for(; i + 2 <= count; i += 2)
+            _mm_storeu_si128((__m128i*)(values + i), zigzag(_mm_loadu_si128((const __m128i*)(values + i))));
+#endif
+        for(; i < count; ++i)
+            values[i] = zigzag(values[i]);
+    }
+
+    inline void unzigzag(uint64_t* values, size_t count)
+    {
+        size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        for(; i + 2 <= count; i += 2)
+            _mm_storeu_si128((__m128i*)(values + i), unzigzag(_mm_loadu_si128((const __m128i*)(values + i))));
+#endif
+        for(; i < count; ++i)
+            values[i] = unzigzag(values[i]);
+    }
+
+    /** Little endian bit stream, written to a buffer with enough room **/
+    class BitWriter
+    {
+    public:
+        BitWriter(char* out) : _out(out), _buffer(0), _bits(0) {}
+
+        /** Writes the count low bits of value **/
+        void write(uint64_t value, unsigned int count)
+        {
+            if(count == 0)
+                return;
+
+            _buffer |= value << _bits;
+            _bits += count;
+            if(_bits >= 64)
+            {
+                flush(8);
+                _bits -= 64;
+                _buffer = _bits ? value >> (count - _bits) : 0;
+            }
+        }
+        /** Returns the end of the stream **/
+        char* finish()
+        {
+            flush((_bits + 7) / 8);
+            return _out;
+        }
+
+    private:
+        void flush(unsigned int bytes)
+        {
+            for(unsigned int i = 0; i < bytes; ++i)
+                *_out++ = (char)(_buffer >> (8 * i));
+        }
+
+        char* _out;
+        uint64_t _buffer;
+        unsigned int _bits;
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const char* begin, const char* end) : _in(begin), _end(end), _buffer(0), _bits(0) {}
+
+        uint64_t read(unsigned int count)
+        {
+            if(count > 32)
+            {
+                uint64_t low = read(32);
+                return low | (read(count - 32) << 32);
+            }
+
+            while(_bits < count)
+            {
+                if(_in == _end)
+                    throw new BinaryException();
+                _buffer |= (uint64_t)(unsigned char)*_in++ << _bits;
+                _bits += 8;
+            }
+
+            uint64_t value = _buffer & (((uint64_t)1 << count) - 1);
+            _buffer >>= count;
+            _bits -= count;
+            return value;
+        }
+
+    private:
+        const char* _in;
+        const char* _end;
+        uint64_t _buffer;
+        unsigned int _bits;
+    };
+
+    /* -- ELEMENTS -- */
+
+    template<typename T>
+    inline void loadElements(const void* data, size_t begin, size_t count, uint64_t* out)
+    {
+        const T* in = static_cast<const T*>(data) + begin;
+        for(size_t i = 0; i < count; ++i)
+            out[i] = (uint64_t)in[i];
+    }
+
+    /** Loads count elements as 64 bits values **/
+    inline void loadNumbers(const Seza::Numbers& numbers, size_t begin, size_t count, uint64_t* out)
+    {
+        switch(numbers.type)
+        {
+        case Seza::int32Numbers: loadElements<int32_t>(numbers.data, begin, count, out); break;
+        case Seza::uint32Numbers: 
+        case Seza::float32Numbers: loadElements<uint32_t>(numbers.data, begin, count, out); break;
+        default: memcpy(out, static_cast<const uint64_t*>(numbers.data) + begin, count * sizeof(uint64_t)); break;
+        }
+    }
+
+    /** Stores count 64 bits values, truncated to the size of the elements **/
+    inline void storeNumbers(Seza::Numbers& numbers, size_t begin, size_t count, const uint64_t* in)
+    {
+        if((numbers.type == Seza::float64Numbers) || (numbers.type == Seza::int64Numbers) || (numbers.type == Seza::uint64Numbers))
+        {
+            memcpy(static_cast<uint64_t*>(numbers.data) + begin, in, count * sizeof(uint64_t));
+            return;
+        }
+
+        uint32_t* out = static_cast<uint32_t*>(numbers.data) + begin;
+        for(size_t i = 0; i < count; ++i)
+            out[i] = (uint32_t)in[i];
+    }
+
+    /* -- VARINTS -- */
+
+    static const size_t varintRun = 16;
+
+#if defined(__SSE2__) || defined(_M_X64)
+    /** Writes 16 values as bytes if all of them are below 0x80. Returns false otherwise **/
+    inline bool narrowBytes(const uint64_t* values, char* out)
+    {
+        __m128i pairs[8];
+        __m128i any = _mm_setzero_si128();
+        for(int k = 0; k < 8; ++k)
+        {
+            pairs[k] = _mm_loadu_si128((const __m128i*)(values + 2 * k));
+            any = _mm_or_si128(any, pairs[k]);
+        }
+        __m128i high = _mm_andnot_si128(_mm_set1_epi64x(0x7F), any);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(high, _mm_setzero_si128())) != 0xFFFF)
+            return false;
+
+        __m128i quads[4]; // Low halves of two pairs
+        for(int k = 0; k < 4; ++k)
+            quads[k] = _mm_unpacklo_epi64(_mm_shuffle_epi32(pairs[2 * k], _MM_SHUFFLE(3, 1, 2, 0)), 
+                _mm_shuffle_epi32(pairs[2 * k + 1], _MM_SHUFFLE(3, 1, 2, 0)));
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(quads[0], quads[1]), _mm_packs_epi32(quads[2], quads[3]));
+        _mm_storeu_si128((__m128i*)out, bytes);
+        return true;
+    }
+
+    /** Zero extends 16 bytes to 64 bits values **/
+    inline void widenBytes(__m128i bytes, uint64_t* values)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i words[2] = { _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero) };
+        for(int w = 0; w < 2; ++w)
+        {
+            __m128i quads[2] = { _mm_unpacklo_epi16(words[w], zero), _mm_unpackhi_epi16(words[w], zero) };
+            for(int q = 0; q < 2; ++q)
+            {
+                _mm_storeu_si128((__m128i*)(values + 8 * w + 4 * q), _mm_unpacklo_epi32(quads[q], zero));
+                _mm_storeu_si128((__m128i*)(values + 8 * w + 4 * q + 2), _mm_unpackhi_epi32(quads[q], zero));
+            }
+        }
+    }
+#endif
+
+    /** Runs of 16 one byte varints are written at once. A run that has longer ones is written 
+    value by value **/
+    inline void writeVarints(Seza::Writer& os, const uint64_t* values, size_t count)
+    {
+        char* begin = os.reserve(count * 10);
+        char* out = begin;
+        size_t i = 0;
+        while(i < count)
+        {
+            size_t end = (count - i < varintRun) ? count : i + varintRun;
+#if defined(__SSE2__) || defined(_M_X64)
+            if((end - i == varintRun) && narrowBytes(values + i, out))
+            {
+                out += varintRun;
+                i = end;
+                continue;
+            }
+#endif
+            for(; i < end; ++i)
+            {
+                uint64_t value = values[i];
+                while(value >= 0x80)
+                {
+                    *out++ = (char)(value | 0x80);
+                    value >>= 7;
+                }
+                *out++ = (char)value;
+            }
+        }
+        os.commit(out - begin);
+    }
+
+    /** Runs of one byte varints are found with a single mask test, 16 at a time with SSE2 or 8 **/
+    inline void readVarints(Seza::Reader& is, uint64_t* values, size_t count)
+    {
+        size_t i = 0;
+        while(i < count)
+        {
+            if(is.available() < 16)
+            {
+                values[i++] = readSize(is);
+                continue;
+            }
+
+            const unsigned char* in = (const unsigned char*)is.cursor();
+#if defined(__SSE2__) || defined(_M_X64)
+            if(count - i >= varintRun)
+            {
+                __m128i bytes = _mm_loadu_si128((const __m128i*)in);
+                if(_mm_movemask_epi8(bytes) == 0)
+                {
+                    widenBytes(bytes, values + i);
+                    i += varintRun;
+                    is.skip(varintRun);
+                    continue;
+                }
+            }
+#endif
+            uint64_t word;
+            memcpy(&word, in, sizeof(word));
+            if((count - i >= 8) && ((word & 0x8080808080808080ULL) == 0))
+            {
+                for(size_t k = 0; k < 8; ++k)
+                    values[i + k] = in[k];
+                i += 8;
+                is.skip(8);
+                continue;
+            }
+
+            uint64_t value = 0;
+            size_t length = 0;
+            for(int shift = 0; ; shift += 7)
+            {
+                if(shift >= 64)
+                    throw new BinaryException();
+                unsigned char c = in[length++];
+                value |= (uint64_t)(c & 0x7F) << shift;
+                if((c & 0x80) == 0)
+                    break;
+            }
+            values[i++] = value;
+            is.skip(length);
+        }
+    }
+
+    /* -- DELTA -- */
+
+    /** Replaces the values by their differences with the previous one. Returns the last value **/
+    inline uint64_t encodeDelta(uint64_t* values, size_t count, uint64_t previous)
+    {
+        size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128i carry = _mm_set1_epi64x((long long)previous);
+        for(; i + 2 <= count; i += 2)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i*)(values + i));
+            __m128i before = _mm_or_si128(_mm_srli_si128(carry, 8), _mm_slli_si128(x, 8));
+            _mm_storeu_si128((__m128i*)(values + i), zigzag(_mm_sub_epi64(x, before)));
+            carry = x;
+        }
+        _mm_storel_epi64((__m128i*)&previous, _mm_unpackhi_epi64(carry, carry));
+#endif
+        for(; i < count; ++i)
+        {
+            uint64_t value = values[i];
+            values[i] = zigzag(value - previous);
+            previous = value;
+        }
+        return previous;
+    }
+
+    /** Prefix sum of the differences. Returns the last value **/
+    inline uint64_t decodeDelta(uint64_t* values, size_t count, uint64_t previous)
+    {
+        size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128i carry = _mm_set1_epi64x((long long)previous);
+        for(; i + 2 <= count; i += 2)
+        {
+            __m128i x = unzigzag(_mm_loadu_si128((const __m128i*)(values + i)));
+            x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi64(x, carry);
+            _mm_storeu_si128((__m128i*)(values + i), x);
+            carry = _mm_unpackhi_epi64(x, x);
+        }
+        if(i > 0)
+            previous = values[i - 1];
+#endif
+        for(; i < count; ++i)
+            previous = values[i] = unzigzag(values[i]) + previous;
+        return previous;
+    }
+
+    /* -- FRAME OF REFERENCE -- */
+
+    /** Writes the minimum of the block, the bit width of the offsets and the packed offsets **/
+    inline void writeFrame(Seza::Writer& os, const uint64_t* values, size_t count)
+    {
+        int64_t minimum = (int64_t)values[0];
+        int64_t maximum = minimum;
+        for(size_t i = 1; i < count; ++i)
+        {
+            int64_t value = (int64_t)values[i];
+            minimum = (value < minimum) ? value : minimum;
+            maximum = (value > maximum) ? value : maximum;
+        }
+        unsigned int width = 64 - countLeadingZeros((uint64_t)maximum - (uint64_t)minimum);
+
+        writeSize(os, zigzag((uint64_t)minimum));
+        os.put((char)width);
+
+        char* begin = os.reserve(codecBlockSize * 8 + 8);
+        BitWriter bits(begin);
+        for(size_t i = 0; i < count; ++i)
+            bits.write(values[i] - (uint64_t)minimum, width);
+        os.commit(bits.finish() - begin);
+    }
+
+    inline void readFrame(Seza::Reader& is, uint64_t* values, size_t count)
+    {
+        uint64_t minimum = unzigzag(readSize(is));
+        int width = is.get();
+        if((width < 0) || (width > 64))
+            throw new BinaryException();
+
+        size_t length = (count * width + 7) / 8;
+        if(!is.require(length))
+            throw new BinaryException();
+
+        BitReader bits(is.cursor(), is.cursor() + length);
+        for(size_t i = 0; i < count; ++i)
+            values[i] = bits.read(width) + minimum;
+        is.skip(length);
+    }
+
+    /* -- XOR -- */
+
+    /** State of the XOR codec between blocks **/
+    struct XorState
+    {
+        XorState() : previous(0), leading(64), trailing(0) {}
+
+        uint64_t previous;
+        unsigned int leading;
+        unsigned int trailing;
+    };
+
+    /** Writes the XOR of each value with the previous one: a 0 bit if it is zero, a 01 prefix and
+    the meaningful bits if they fit in the window of the previous one, or a 11 prefix, the count of
+    leading zeros, the count of meaningful bits and the meaningful bits. Blocks are prefixed by
+    their size in bytes **/
+    inline void writeXor(Seza::Writer& os, uint64_t* values, size_t count, XorState& state)
+    {
+        uint64_t last = values[count - 1];
+        for(size_t i = count; i > 1; --i)
+            values[i - 1] ^= values[i - 2];
+        values[0] ^= state.previous;
+        state.previous = last;
+
+        char buffer[codecBlockSize * 10 + 8];
+        BitWriter bits(buffer);
+        for(size_t i = 0; i < count; ++i)
+        {
+            uint64_t value = values[i];
+            if(value == 0)
+            {
+                bits.write(0, 1);
+                continue;
+            }
+
+            unsigned int leading = countLeadingZeros(value);
+            unsigned int trailing = countTrailingZeros(value);
+            if(leading > 31)
+                leading = 31;
+
+            if((leading >= state.leading) && (trailing >= state.trailing))
+            {
+                bits.write(1, 2);
+                bits.write(value >> state.trailing, 64 - state.leading - state.trailing);
+            }
+            else
+            {
+                unsigned int length = 64 - leading - trailing;
+                bits.write(3, 2);
+                bits.write(leading, 5);
+                bits.write(length - 1, 6);
+                bits.write(value >> trailing, length);
+                state.leading = leading;
+                state.trailing = trailing;
+            }
+        }
+
+        size_t length = bits.finish() - buffer;
+        writeSize(os, length);
+        os.write(buffer, length);
+    }
+
+    inline void readXor(Seza::Reader& is, uint64_t* values, size_t count, XorState& state)
+    {
+        // Blocks are written from a buffer of codecBlockSize * 10 + 8 bytes
+        size_t length = readSize(is);
+        if((length > codecBlockSize * 10 + 8) || !is.require(length))
+            throw new BinaryException();
+
+        BitReader bits(is.cursor(), is.cursor() + length);
+        for(size_t i = 0; i < count; ++i)
+        {
+            uint64_t value = 0;
+            if(bits.read(1))
+            {
+                if(bits.read(1))
+                {
+                    state.leading = (unsigned int)bits.read(5);
+                    unsigned int length = (unsigned int)bits.read(6) + 1;
+                    if(state.leading + length > 64)
+                        throw new BinaryException();
+                    state.trailing = 64 - state.leading - length;
+                }
+                else if(state.leading == 64)
+                    throw new BinaryException();
+
+                value = bits.read(64 - state.leading - state.trailing) << state.trailing;
+            }
+            state.previous = values[i] = state.previous ^ value;
+        }
+        is.skip(length);
+    }
+
+    /* -- CODECS -- */
+
+    /** Writes the codec and the encoded elements **/
+    inline void writeNumbers(Seza::Writer& os, Seza::NumberCodec codec, const Seza::Numbers& numbers)
+    {
+        os.put((char)codec);
+
+        uint64_t values[codecBlockSize];
+        uint64_t previous = 0;
+        XorState state;
+        for(size_t begin = 0; begin < numbers.size; begin += codecBlockSize)
+        {
+            size_t count = (numbers.size - begin < codecBlockSize) ? numbers.size - begin : codecBlockSize;
+            loadNumbers(numbers, begin, count, values);
+
+            switch(codec)
+            {
+            case Seza::deltaCodec: 
+                previous = encodeDelta(values, count, previous);
+                writeVarints(os, values, count);
+                break;
+            case Seza::varintCodec:
+                zigzag(values, count);
+                writeVarints(os, values, count);
+                break;
+            case Seza::frameOfReferenceCodec: 
+                writeFrame(os, values, count); 
+                break;
+            case Seza::xorCodec: 
+                writeXor(os, values, count, state); 
+                break;
+            default: 
+                throw new BinaryException();
+            }
+        }
+    }
+
+    /** Reads the codec and appends count elements decoded in place. The count is not trusted: the 
+    container grows a block at a time, as each block is decoded **/
+    inline void readNumbers(Seza::Reader& is, const Seza::SerializableSTLContainer& container, size_t count)
+    {
+        int codec = is.get();
+
+        size_t size = container.size();
+        uint64_t values[codecBlockSize];
+        uint64_t previous = 0;
+        XorState state;
+        for(size_t begin = 0; begin < count; begin += codecBlockSize)
+        {
+            size_t length = (count - begin < codecBlockSize) ? count - begin : codecBlockSize;
+
+            switch(codec)
+            {
+            case Seza::deltaCodec: 
+                readVarints(is, values, length);
+                previous = decodeDelta(values, length, previous);
+                break;
+            case Seza::varintCodec:
+                readVarints(is, values, length);
+                unzigzag(values, length);
+                break;
+            case Seza::frameOfReferenceCodec: 
+                readFrame(is, values, length); 
+                break;
+            case Seza::xorCodec: 
+                readXor(is, values, length, state); 
+                break;
+            default: 
+                throw new BinaryException();
+            }
+
+            Seza::Numbers numbers;
+            container.resizeNumbers(size + length, numbers);
+            storeNumbers(numbers, size, length, values);
+            size += length;
+        }
+    }
+}
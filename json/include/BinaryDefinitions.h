@@ -0,0 +1,165 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+#include <string.h>
+
+#include <exception>
+#include <typeinfo>
+
+#include "SezaReader.h"
+#include "SezaWriter.h"
+
+// Binary Definitions
+namespace Binary
+{
+    /** This exception is thrown when the input is not valid, or when a wide stream is used: 
+    binary data has no wide form **/
+    class BinaryException : public std::exception
+    {
+    public:
+      const char* what() const throw() { return "Invalid binary format!\n"; }
+    };
+
+    static const char null = 0;
+
+    /* -- FIXED WIDTH SCALARS -- */
+
+    /** Writes value as sizeof(Unsigned) little endian bytes **/
+    template<typename Unsigned>
+    inline void writeFixed(Seza::Writer& os, Unsigned value)
+    {
+        char* out = os.reserve(sizeof(Unsigned));
+        for(size_t i = 0; i < sizeof(Unsigned); ++i)
+        {
+            out[i] = (char)(value & 0xFF);
+            value = (Unsigned)(value >> 4 >> 4); // Also valid for one byte types
+        }
+        os.commit(sizeof(Unsigned));
+    }
+
+    /** Reads sizeof(Unsigned) little endian bytes **/
+    template<typename Unsigned>
+    inline Unsigned readFixed(Seza::Reader& is)
+    {
+        if(!is.require(sizeof(Unsigned)))
+            throw new BinaryException();
+
+        const unsigned char* in = (const unsigned char*)is.cursor();
+        Unsigned value = 0;
+        for(size_t i = 0; i < sizeof(Unsigned); ++i)
+            value = (Unsigned)(value | ((Unsigned)in[i] << (8 * i)));
+        is.skip(sizeof(Unsigned));
+        return value;
+    }
+
+    /* -- VARIABLE LENGTH SIZES -- */
+
+    /** Writes a size as a LEB128 varint: 7 bits per byte, the high bit set in all but the last one **/
+    inline void writeSize(Seza::Writer& os, uint64_t size)
+    {
+        char buffer[10];
+        size_t length = 0;
+        while(size >= 0x80)
+        {
+            buffer[length++] = (char)(size | 0x80);
+            size >>= 7;
+        }
+        buffer[length++] = (char)size;
+        os.write(buffer, length);
+    }
+
+    inline uint64_t readSize(Seza::Reader& is)
+    {
+        uint64_t size = 0;
+        for(int shift = 0; shift < 64; shift += 7)
+        {
+            int c = is.get();
+            if(c == Seza::Reader::eof)
+                throw new BinaryException();
+
+            size |= (uint64_t)(c & 0x7F) << shift;
+            if((c & 0x80) == 0)
+                return size;
+        }
+        throw new BinaryException();
+    }
+
+    /* -- BLOCKS -- */
+
+    inline bool isLittleEndian()
+    {
+        const uint16_t one = 1;
+        return *(const unsigned char*)&one == 1;
+    }
+
+    /** Elements whose raw bytes are their fixed width encoding: numbers with the same size in 
+    memory and in the format, on little endian hosts, and classes declared with a trivial layout **/
+    inline bool isRawBlock(const std::type_info& type, bool trivialLayout)
+    {
+        if(!isLittleEndian())
+            return false;
+
+        return trivialLayout || 
+            (type == typeid(char)) || (type == typeid(signed char)) || (type == typeid(unsigned char)) ||
+            (type == typeid(short)) || (type == typeid(unsigned short)) || 
+            (type == typeid(int)) || (type == typeid(unsigned int)) || 
+            (((type == typeid(long)) || (type == typeid(unsigned long))) && (sizeof(long) == 8)) ||
+            (type == typeid(long long)) || (type == typeid(unsigned long long)) || 
+            (type == typeid(float)) || (type == typeid(double)) || (type == typeid(long double));
+    }
+
+    /** Copies size bytes from the reader, a buffer at a time **/
+    inline void readBlock(Seza::Reader& is, char* data, size_t size)
+    {
+        while(size > 0)
+        {
+            if(!is.fill())
+                throw new BinaryException();
+
+            size_t length = (is.available() < size) ? is.available() : size;
+            memcpy(data, is.cursor(), length);
+            is.skip(length);
+            data += length;
+            size -= length;
+        }
+    }
+
+    /* -- CLASS IDENTITY -- */
+
+    /** Classes are identified by the 32 bits FNV-1a hash of their name **/
+    inline uint32_t classId(const char* name)
+    {
+        uint32_t value = 2166136261u;
+        for(; *name != '\0'; ++name)
+            value = (value ^ (unsigned char)*name) * 16777619u;
+        return value;
+    }
+}
@@ -0,0 +1,249 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "Seza.h"
+#include "BinaryDefinitions.h"
+#include "BinaryCodecs.h"
+
+/** Reads the format written by BinarySerializer. Containers are read with their known count **/
+class BinaryDeserializer : public Seza::DeserializerImpl<BinaryDeserializer>
+{
+protected:
+    friend class Seza::DeserializerImpl<BinaryDeserializer>;
+
+    // null
+    void readNull(Seza::Reader& is)
+    {
+        if(is.get() != Binary::null)
+            throw new Binary::BinaryException();
+    }
+
+    // Values
+    void readValue(Seza::Reader& is, bool& value) { value = (Binary::readFixed<uint8_t>(is) != 0); }
+    void readValue(Seza::Reader& is, char& value) { value = (char)Binary::readFixed<uint8_t>(is); }
+    void readValue(Seza::Reader& is, unsigned char& value) { value = Binary::readFixed<uint8_t>(is); }
+    void readValue(Seza::Reader& is, short& value) { value = (short)Binary::readFixed<uint16_t>(is); }
+    void readValue(Seza::Reader& is, unsigned short& value) { value = Binary::readFixed<uint16_t>(is); }
+    void readValue(Seza::Reader& is, int& value) { value = (int)Binary::readFixed<uint32_t>(is); }
+    void readValue(Seza::Reader& is, unsigned int& value) { value = Binary::readFixed<uint32_t>(is); }
+    void readValue(Seza::Reader& is, long& value) { value = (long)(int64_t)Binary::readFixed<uint64_t>(is); }
+    void readValue(Seza::Reader& is, unsigned long& value) { value = (unsigned long)Binary::readFixed<uint64_t>(is); }
+    void readValue(Seza::Reader& is, long long& value) { value = (long long)Binary::readFixed<uint64_t>(is); }
+    void readValue(Seza::Reader& is, unsigned long long& value) { value = Binary::readFixed<uint64_t>(is); }
+
+    void readValue(Seza::Reader& is, float& value) 
+    { 
+        uint32_t bits = Binary::readFixed<uint32_t>(is);
+        memcpy(&value, &bits, sizeof(value));
+    }
+    void readValue(Seza::Reader& is, double& value) 
+    { 
+        uint64_t bits = Binary::readFixed<uint64_t>(is);
+        memcpy(&value, &bits, sizeof(value));
+    }
+    void readValue(Seza::Reader& is, long double& value) 
+    { 
+        if(!is.require(sizeof(value)))
+            throw new Binary::BinaryException();
+        memcpy(&value, is.cursor(), sizeof(value));
+        is.skip(sizeof(value));
+    }
+
+    // String
+    template<typename A>
+    void readString(Seza::Reader& is, std::basic_string<char, std::char_traits<char>, A>& value)
+    {
+        // The size is not trusted, the string grows a buffer at a time as the bytes are read
+        size_t size = readSize(is);
+        value.clear();
+        while(size > 0)
+        {
+            if(!is.fill())
+                throw new Binary::BinaryException();
+
+            size_t length = std::min(is.available(), size);
+            value.append(is.cursor(), length);
+            is.skip(length);
+            size -= length;
+        }
+    }
+
+    void readString(Seza::Reader& is, std::wstring& value)
+    {
+        size_t size = readSize(is);
+        value.clear();
+        value.reserve(std::min(size, is.available() / sizeof(uint32_t)));
+        for(; size > 0; --size)
+            value.push_back((wchar_t)Binary::readFixed<uint32_t>(is));
+    }
+
+    // Member names
+    const Seza::MemberDescriptor* readName(Seza::Reader& is, const Seza::MemberTable& members)
+    {
+        size_t index = readSize(is);
+        return (index < members.size()) ? members.begin() + index : 0;
+    }
+
+    // Arrays
+    template<typename T> 
+    size_t readArray(Seza::Reader& is, T* vector, const size_t& size)
+    {
+        size_t length = readSize(is);
+        if(length > size)
+            throw new Binary::BinaryException();
+
+        if(Binary::isRawBlock(typeid(T), false))
+        {
+            Binary::readBlock(is, (char*)vector, length * sizeof(T));
+            return length;
+        }
+
+        for(size_t i = 0; i < length; ++i)
+            this->read(is, vector[i]);
+
+        return length;
+    }
+    
+    // STL containers
+    template<typename Container>
+    void readSTLContainer(Seza::Reader& is, Container& container)
+    {
+        this->checkStack();
+        size_t count = readSize(is);
+
+        // The container is restored to its size if the numbers are not read
+        size_t size = container.size();
+        Seza::Numbers numbers;
+        if((container.getCodec() != Seza::noCodec) && container.resizeNumbers(size, numbers))
+        {
+            try
+            {
+                Binary::readNumbers(is, container, count);
+            }
+            catch(...)
+            {
+                container.resizeNumbers(size, numbers);
+                throw;
+            }
+            return;
+        }
+
+        Seza::Block block;
+        if(container.getBlock(block) && Binary::isRawBlock(*block.type, block.trivialLayout) &&
+            (count <= (size_t)-1 / block.elementSize))
+        {
+            // Arrays are not resized, their elements are replaced when the count matches
+            if(container.isReservable())
+            {
+                readBlocks(is, container, count, block.elementSize);
+                return;
+            }
+            if(container.resizeBlock(count, block))
+            {
+                Binary::readBlock(is, (char*)block.data, count * block.elementSize);
+                return;
+            }
+        }
+
+        // Each element takes at least one byte, so the count is only trusted up to the bytes available
+        container.reserve(std::min(count, is.available()));
+        for(; count > 0; --count)
+            container.deserializeElem(this, is);
+    }
+
+    // Serializable class
+    template<typename Object>
+    void readSerializable(Seza::Reader& is, const Object& object)
+    {
+        this->checkStack();
+        if(Binary::readFixed<uint32_t>(is) != Binary::classId(object.getClassName()))
+            throw new Binary::BinaryException();
+
+        for(size_t count = readSize(is); count > 0; --count)
+        {
+            if(!object.deserializeElemName(this, is))
+                throw new Binary::BinaryException();
+
+            object.deserializeElemValue(this, is);
+        }
+    }
+
+    /** Appends count elements copied as raw bytes. The count is not trusted: the container grows 
+    by the elements available in the buffer of the reader, and is restored to its size if they are 
+    not read **/
+    template<typename Container>
+    static void readBlocks(Seza::Reader& is, Container& container, size_t count, size_t elementSize)
+    {
+        const size_t size = container.size();
+        Seza::Block block;
+        try
+        {
+            for(size_t done = 0; done < count; )
+            {
+                if(!is.fill())
+                    throw new Binary::BinaryException();
+
+                size_t length = std::min(count - done, std::max<size_t>(is.available() / elementSize, 1));
+                if(!container.resizeBlock(size + done + length, block))
+                    throw new Binary::BinaryException();
+
+                Binary::readBlock(is, (char*)block.data + (size + done) * elementSize, length * elementSize);
+                done += length;
+            }
+        }
+        catch(...)
+        {
+            container.resizeBlock(size, block);
+            throw;
+        }
+    }
+
+    /** Sizes that do not fit the platform are not valid **/
+    static size_t readSize(Seza::Reader& is)
+    {
+        uint64_t size = Binary::readSize(is);
+        if(size > (uint64_t)(size_t)-1)
+            throw new Binary::BinaryException();
+        return (size_t)size;
+    }
+
+    // Wide streams
+    void readNull(std::wistream& is) { throw new Binary::BinaryException(); }
+    template<typename T> void readValue(std::wistream& is, T& value) { throw new Binary::BinaryException(); }
+    template<typename T> void readString(std::wistream& is, T& value) { throw new Binary::BinaryException(); }
+    const Seza::MemberDescriptor* readName(std::wistream& is, const Seza::MemberTable& members) { throw new Binary::BinaryException(); }
+    template<typename T> size_t readArray(std::wistream& is, T* vector, const size_t& size) { throw new Binary::BinaryException(); }
+    template<typename Container> void readSTLContainer(std::wistream& is, Container& container) { throw new Binary::BinaryException(); }
+    template<typename Object> void readSerializable(std::wistream& is, const Object& object) { throw new Binary::BinaryException(); }
+};
@@ -0,0 +1,162 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include "Seza.h"
+#include "BinaryDefinitions.h"
+#include "BinaryCodecs.h"
+
+/** Compact binary format. Scalars are written with a fixed width in little endian order, 
+strings and containers are prefixed by their size, and classes by the hash of their name. 
+Members are written as their index in the members table followed by their value **/
+class BinarySerializer : public Seza::SerializerImpl<BinarySerializer>
+{
+protected:
+
+    friend class Seza::SerializerImpl<BinarySerializer>;
+
+    // null
+    void writeNull(Seza::Writer& os)
+    {
+        os.put(Binary::null);
+    }
+
+    // Values
+    void writeValue(Seza::Writer& os, const bool& value) { Binary::writeFixed<uint8_t>(os, value ? 1 : 0); }
+    void writeValue(Seza::Writer& os, const char& value) { Binary::writeFixed<uint8_t>(os, (uint8_t)value); }
+    void writeValue(Seza::Writer& os, const unsigned char& value) { Binary::writeFixed<uint8_t>(os, value); }
+    void writeValue(Seza::Writer& os, const short& value) { Binary::writeFixed<uint16_t>(os, (uint16_t)value); }
+    void writeValue(Seza::Writer& os, const unsigned short& value) { Binary::writeFixed<uint16_t>(os, value); }
+    void writeValue(Seza::Writer& os, const int& value) { Binary::writeFixed<uint32_t>(os, (uint32_t)value); }
+    void writeValue(Seza::Writer& os, const unsigned int& value) { Binary::writeFixed<uint32_t>(os, value); }
+    void writeValue(Seza::Writer& os, const long& value) { Binary::writeFixed<uint64_t>(os, (uint64_t)(int64_t)value); }
+    void writeValue(Seza::Writer& os, const unsigned long& value) { Binary::writeFixed<uint64_t>(os, value); }
+    void writeValue(Seza::Writer& os, const long long& value) { Binary::writeFixed<uint64_t>(os, (uint64_t)value); }
+    void writeValue(Seza::Writer& os, const unsigned long long& value) { Binary::writeFixed<uint64_t>(os, value); }
+
+    void writeValue(Seza::Writer& os, const float& value) 
+    { 
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        Binary::writeFixed(os, bits);
+    }
+    void writeValue(Seza::Writer& os, const double& value) 
+    { 
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        Binary::writeFixed(os, bits);
+    }
+    /** Long doubles are written in the native representation of the platform **/
+    void writeValue(Seza::Writer& os, const long double& value) 
+    { 
+        os.write((const char*)&value, sizeof(value));
+    }
+
+    // Strings
+    /** Narrow strings of any allocator and string views **/
+    template<typename Type>
+    void writeString(Seza::Writer& os, const Type& value)
+    {
+        Binary::writeSize(os, value.size());
+        os.write(value.data(), value.size());
+    }
+
+    void writeString(Seza::Writer& os, const std::wstring& value)
+    {
+        Binary::writeSize(os, value.size());
+        for(size_t i = 0; i < value.size(); ++i)
+            Binary::writeFixed<uint32_t>(os, (uint32_t)value[i]);
+    }
+
+    // Arrays
+    /** Arrays of numbers are copied as a block **/
+    template<typename Type> 
+    void writeArray(Seza::Writer& os, const Type* vector, const size_t& size)
+    {
+        Binary::writeSize(os, size);
+        if(Binary::isRawBlock(typeid(Type), false))
+        {
+            os.write((const char*)vector, size * sizeof(Type));
+            return;
+        }
+        
+        for(size_t i=0; i<size; ++i)
+            this->write(os, vector[i]);
+    }
+
+    // STL conatiners
+    /** Vectors of numbers declared with a codec are encoded as a whole, and contiguous elements
+    with a raw encoding are copied as a block **/
+    template<typename Container>
+    void writeSTLContainer(Seza::Writer& os, const Container& container)
+    {
+        Binary::writeSize(os, container.size());
+
+        Seza::Numbers numbers;
+        if((container.getCodec() != Seza::noCodec) && container.getNumbers(numbers))
+        {
+            Binary::writeNumbers(os, container.getCodec(), numbers);
+            return;
+        }
+
+        Seza::Block block;
+        if(container.getBlock(block) && Binary::isRawBlock(*block.type, block.trivialLayout))
+        {
+            os.write((const char*)block.data, block.size * block.elementSize);
+            return;
+        }
+
+        for(container.begin(); !container.isEnd(); container.next())
+            container.serializeElem(this, os);
+    }
+
+    // Serializable class
+    template<typename Object>
+    void writeSerializable(Seza::Writer& os, const Object& object)
+    {
+        Binary::writeFixed<uint32_t>(os, Binary::classId(object.getClassName()));
+        Binary::writeSize(os, object.membersCount());
+
+        for(object.begin(); !object.isEnd(); object.next())
+        {
+            Binary::writeSize(os, object.getElemIndex());
+            object.serializeElemValue(this, os);
+        }
+    }
+
+    // Wide streams
+    void writeNull(std::wostream& os) { throw new Binary::BinaryException(); }
+    template<typename Type> void writeValue(std::wostream& os, const Type& value) { throw new Binary::BinaryException(); }
+    template<typename Type> void writeString(std::wostream& os, const Type& value) { throw new Binary::BinaryException(); }
+    template<typename Type> void writeArray(std::wostream& os, const Type* vector, const size_t& size) { throw new Binary::BinaryException(); }
+    template<typename Container> void writeSTLContainer(std::wostream& os, const Container& container) { throw new Binary::BinaryException(); }
+    template<typename Object> void writeSerializable(std::wostream& os, const Object& object) { throw new Binary::BinaryException(); }
+};
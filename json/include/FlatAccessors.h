@@ -0,0 +1,495 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Seza.h"
+#include "BinaryDefinitions.h"
+#include "FlatDefinitions.h"
+
+// Flat Accessors
+/** Views that read the buffers written by FlatSerializer in place. Scalars are returned by 
+value, strings, containers and classes as views over the buffer, which has to outlive them. 
+root() only checks the header: the buffer is trusted to be written by FlatSerializer. Buffers 
+that are not trusted, like files that may be truncated or corrupt, are checked whole by verify() **/
+namespace Flat
+{
+    template<typename T, typename Enable = void> struct Traits;
+
+    /* -- VIEWS -- */
+
+    /** String stored in the buffer. It is followed by a null character **/
+    template<typename Char>
+    class BasicString
+    {
+    public:
+        BasicString() : _data(emptyString()), _size(0) {}
+        BasicString(const Char* data, size_t size) : _data(data), _size(size) {}
+
+        const Char* data() const { return _data; }
+        const Char* c_str() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return (_size == 0); }
+        Char operator[](size_t i) const { return _data[i]; }
+        std::basic_string<Char> str() const { return std::basic_string<Char>(_data, _size); }
+
+        int compare(const Char* other, size_t size) const
+        {
+            size_t common = (_size < size) ? _size : size;
+            for(size_t i = 0; i < common; ++i)
+            {
+                if(_data[i] != other[i])
+                    return (_data[i] < other[i]) ? -1 : 1;
+            }
+            return (_size < size) ? -1 : (_size > size) ? 1 : 0;
+        }
+        bool operator==(const std::basic_string<Char>& other) const { return compare(other.data(), other.size()) == 0; }
+        bool operator!=(const std::basic_string<Char>& other) const { return compare(other.data(), other.size()) != 0; }
+        bool operator==(const Char* other) const { return compare(other, std::char_traits<Char>::length(other)) == 0; }
+        bool operator!=(const Char* other) const { return compare(other, std::char_traits<Char>::length(other)) != 0; }
+
+    private:
+        static const Char* emptyString() { static const Char terminator = 0; return &terminator; }
+
+        const Char* _data;
+        size_t _size;
+    };
+
+    template<typename Char>
+    inline bool operator==(const Char* a, const BasicString<Char>& b) { return b == a; }
+    template<typename Char>
+    inline bool operator==(const std::basic_string<Char>& a, const BasicString<Char>& b) { return b == a; }
+
+    typedef BasicString<char> String;
+    typedef BasicString<wchar_t> WString;
+
+    /** Container stored in the buffer **/
+    template<typename T>
+    class Vector
+    {
+    public:
+        typedef typename Traits<T>::View View;
+
+        /** Distance between elements **/
+        static const size_t stride = alignUp(Traits<T>::size, Traits<T>::alignment);
+
+        Vector() : _base(0), _data(0), _size(0) {}
+        Vector(const char* base, const char* data, size_t size) : _base(base), _data(data), _size(size) {}
+
+        size_t size() const { return _size; }
+        bool empty() const { return (_size == 0); }
+        View operator[](size_t i) const { return Traits<T>::get(_base, _data + i * stride); }
+        View at(size_t i) const 
+        { 
+            if(i >= _size)
+                throw new FlatException();
+            return (*this)[i];
+        }
+        /** Elements of arithmetic types are stored contiguously and aligned **/
+        const T* data() const 
+        { 
+            static_assert(std::is_arithmetic<T>::value, "Only elements of arithmetic types are stored in place");
+            return reinterpret_cast<const T*>(_data); 
+        }
+        const T* begin() const { return data(); }
+        const T* end() const { return data() + _size; }
+
+    protected:
+        const char* _base;
+        const char* _data;
+        size_t _size;
+    };
+
+    /** Pair stored in the buffer. The second element follows the first one with its alignment **/
+    template<typename K, typename T>
+    class Pair
+    {
+    public:
+        Pair() : _base(0), _data(0) {}
+        Pair(const char* base, const char* data) : _base(base), _data(data) {}
+
+        typename Traits<K>::View first() const { return Traits<K>::get(_base, _data); }
+        typename Traits<T>::View second() const 
+        { 
+            return Traits<T>::get(_base, _data + alignUp(Traits<K>::size, Traits<T>::alignment)); 
+        }
+
+    private:
+        const char* _base;
+        const char* _data;
+    };
+
+    /** Ordering between the keys stored in the buffer and the keys looked up **/
+    template<typename T>
+    inline bool lessThan(const T& a, const T& b) { return a < b; }
+    template<typename Char>
+    inline bool lessThan(const BasicString<Char>& a, const std::basic_string<Char>& b) { return a.compare(b.data(), b.size()) < 0; }
+    template<typename Char>
+    inline bool lessThan(const std::basic_string<Char>& a, const BasicString<Char>& b) { return b.compare(a.data(), a.size()) > 0; }
+
+    /** Ordered map stored in the buffer. Keys are looked up with a binary search **/
+    template<typename K, typename T>
+    class Map : public Vector<std::pair<K, T> >
+    {
+    public:
+        Map() {}
+        Map(const char* base, const char* data, size_t size) : Vector<std::pair<K, T> >(base, data, size) {}
+
+        /** Returns the index of the key, or size() if it is not stored **/
+        size_t find(const K& key) const
+        {
+            size_t begin = 0;
+            size_t end = this->_size;
+            while(begin < end)
+            {
+                size_t middle = begin + (end - begin) / 2;
+                if(lessThan((*this)[middle].first(), key))
+                    begin = middle + 1;
+                else
+                    end = middle;
+            }
+            return ((begin < this->_size) && !lessThan(key, (*this)[begin].first())) ? begin : this->_size;
+        }
+        bool contains(const K& key) const { return find(key) != this->_size; }
+        /** Returns the value of the key. Throws if it is not stored **/
+        typename Traits<T>::View at(const K& key) const
+        {
+            size_t index = find(key);
+            if(index == this->_size)
+                throw new FlatException();
+            return (*this)[index].second();
+        }
+    };
+
+    /** Members are identified by their wide serialize function, which is the same for the
+    members declared with a number codec **/
+    inline size_t findMember(const Seza::MemberTable& members, void (*serialize)(Seza::Serializer*, std::wostream&, void*))
+    {
+        for(const Seza::MemberDescriptor* member = members.begin(); member != members.end(); ++member)
+        {
+            if(member->wserialize == serialize)
+                return (size_t)(member - members.begin());
+        }
+        throw new FlatException(); // Not registered
+    }
+
+    /** Finds the member M of the class C in its members table **/
+    template<class C, typename T, T C::*M>
+    inline size_t memberIndex()
+    {
+        static const size_t index = findMember(Seza::SerializableClass<C>::getMembers(),
+            static_cast<void (*)(Seza::Serializer*, std::wostream&, void*)>(&Seza::Member<C, T, M>::serialize));
+        return index;
+    }
+
+    /** Type and class of a pointer to member **/
+    template<typename P> struct MemberPointer;
+    template<class C, typename T> 
+    struct MemberPointer<T C::*>
+    {
+        typedef C Class;
+        typedef T Type;
+    };
+
+    /** Returns the value of the slot, or of its out of line data if it is wider than a slot. 
+    Missing slots read as zero **/
+    template<typename T>
+    inline typename Traits<T>::View readSlot(const char* base, const char* slot)
+    {
+        alignas(16) static const char zero[16] = {};
+        if(slot == 0)
+            return Traits<T>::get(base, zero);
+        if(Traits<T>::size > slotSize)
+            return Traits<T>::get(base, base + slotOffset(slot));
+        return Traits<T>::get(base, slot);
+    }
+
+    /** Instance of a registered class stored in the buffer. Members are read with
+    get<&Class::member>(), or get<Type, &Class::member>() before C++17 **/
+    template<class C>
+    class Table
+    {
+    public:
+        Table() : _base(0), _table(0), _size(0) {}
+        Table(const char* base, const char* table, size_t size) : _base(base), _table(table), _size(size) {}
+
+        /** Count of members stored. Members added to the class later are not **/
+        size_t size() const { return _size; }
+
+        template<typename T, T C::*M>
+        bool has() const { return memberIndex<C, T, M>() < _size; }
+
+        template<typename T, T C::*M>
+        typename Traits<T>::View get() const 
+        { 
+            size_t index = memberIndex<C, T, M>();
+            return readSlot<T>(_base, (index < _size) ? _table + index * slotSize : 0);
+        }
+
+#if __cplusplus >= 201703L
+        template<auto M>
+        bool has() const { return has<typename MemberPointer<decltype(M)>::Type, M>(); }
+
+        template<auto M>
+        typename Traits<typename MemberPointer<decltype(M)>::Type>::View get() const 
+        { 
+            return get<typename MemberPointer<decltype(M)>::Type, M>(); 
+        }
+#endif
+
+    private:
+        const char* _base;
+        const char* _table;
+        size_t _size;
+    };
+
+    /* -- VERIFICATION -- */
+
+    /** Buffer being verified. Each value visited takes at least a byte of a buffer written by 
+    FlatSerializer, so the values visited are bounded by its size even if corrupt offsets point 
+    back to values already visited **/
+    struct Bounds
+    {
+        const char* base;
+        size_t size;
+        size_t budget;
+    };
+
+    /** Checks that count values of stride bytes at offset are inside the buffer and aligned **/
+    inline void verifyRange(Bounds& bounds, size_t offset, size_t count, size_t stride, size_t alignment)
+    {
+        if((bounds.budget == 0) || (offset % alignment != 0) || (offset > bounds.size) || 
+            ((stride != 0) && (count > (bounds.size - offset) / stride)))
+        {
+            throw new FlatException();
+        }
+        --bounds.budget;
+    }
+
+    template<typename T>
+    inline void verifySlot(Bounds& bounds, const char* slot);
+
+    /** Verifies the slot of the member visited **/
+    struct SlotVerifier
+    {
+        SlotVerifier(Bounds& bounds, const char* slot) : bounds(bounds), slot(slot) {}
+
+        template<typename M>
+        void operator()(const M& member) const { verifySlot<typename M::Type>(bounds, slot); }
+
+        Bounds& bounds;
+        const char* slot;
+    };
+
+    /* -- TRAITS -- */
+
+    /** Registered classes **/
+    template<typename T, typename Enable>
+    struct Traits
+    {
+        typedef Table<T> View;
+        static const size_t size = slotSize;
+        static const size_t alignment = slotSize;
+        static View get(const char* base, const char* p) { return View(base, base + slotOffset(p), slotCount(p)); }
+        static bool isRoot(uint32_t id) { return id == Binary::classId(Seza::SerializableClass<T>::getName()); }
+        /** Members stored that the class does not have are not verified, they are not read **/
+        static void verify(Bounds& bounds, const char* p)
+        {
+            verifyRange(bounds, slotOffset(p), slotCount(p), slotSize, 1);
+            size_t count = std::min<size_t>(slotCount(p), Seza::SerializableClass<T>::getMembers().size());
+            for(size_t i = 0; i < count; ++i)
+                Seza::SerializableClass<T>::visitMember(i, SlotVerifier(bounds, bounds.base + slotOffset(p) + i * slotSize));
+        }
+    };
+
+    /** Scalars are stored in place **/
+    template<typename T>
+    struct Traits<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    {
+        typedef T View;
+        static const size_t size = sizeof(T);
+        static const size_t alignment = alignof(T);
+        static View get(const char* base, const char* p) 
+        { 
+            T value;
+            memcpy(&value, p, sizeof(T));
+            return value;
+        }
+        static bool isRoot(uint32_t id) { return id == 0; }
+        static void verify(Bounds& bounds, const char* p) {}
+    };
+
+    template<typename Char, typename Traits_, typename A>
+    struct Traits<std::basic_string<Char, Traits_, A> >
+    {
+        typedef BasicString<Char> View;
+        static const size_t size = slotSize;
+        static const size_t alignment = slotSize;
+        static View get(const char* base, const char* p) 
+        { 
+            return (slotCount(p) == 0) ? View() : View(reinterpret_cast<const Char*>(base + slotOffset(p)), slotCount(p)); 
+        }
+        static bool isRoot(uint32_t id) { return id == 0; }
+        /** Strings are followed by a null character **/
+        static void verify(Bounds& bounds, const char* p)
+        {
+            if(slotCount(p) == 0)
+                return;
+            verifyRange(bounds, slotOffset(p), (size_t)slotCount(p) + 1, sizeof(Char), alignof(Char));
+            Char terminator;
+            memcpy(&terminator, bounds.base + slotOffset(p) + slotCount(p) * sizeof(Char), sizeof(Char));
+            if(terminator != 0)
+                throw new FlatException();
+        }
+    };
+
+    /** Containers of single elements **/
+    template<typename T>
+    struct ListTraits
+    {
+        typedef Vector<T> View;
+        static const size_t size = slotSize;
+        static const size_t alignment = slotSize;
+        static View get(const char* base, const char* p) { return View(base, base + slotOffset(p), slotCount(p)); }
+        static bool isRoot(uint32_t id) { return id == 0; }
+        /** Elements of arithmetic types are read in place, so they have to be aligned **/
+        static void verify(Bounds& bounds, const char* p)
+        {
+            const bool arithmetic = std::is_arithmetic<T>::value;
+            verifyRange(bounds, slotOffset(p), slotCount(p), Vector<T>::stride, arithmetic ? Traits<T>::alignment : 1);
+            if(arithmetic)
+                return;
+            const char* data = bounds.base + slotOffset(p);
+            for(size_t i = 0; i < slotCount(p); ++i)
+                Traits<T>::verify(bounds, data + i * Vector<T>::stride);
+        }
+    };
+
+    template<typename T, typename A> struct Traits<std::vector<T, A> > : ListTraits<T> {};
+    template<typename T, typename A> struct Traits<std::deque<T, A> > : ListTraits<T> {};
+    template<typename T, typename A> struct Traits<std::list<T, A> > : ListTraits<T> {};
+    template<typename T, typename A> struct Traits<std::forward_list<T, A> > : ListTraits<T> {};
+    template<typename T, size_t N> struct Traits<std::array<T, N> > : ListTraits<T> {};
+    template<typename T, typename L, typename A> struct Traits<std::set<T, L, A> > : ListTraits<T> {};
+    template<typename T, typename L, typename A> struct Traits<std::multiset<T, L, A> > : ListTraits<T> {};
+    template<typename T, typename H, typename E, typename A> struct Traits<std::unordered_set<T, H, E, A> > : ListTraits<T> {};
+    template<typename T, typename H, typename E, typename A> struct Traits<std::unordered_multiset<T, H, E, A> > : ListTraits<T> {};
+    template<typename K, typename T, typename L, typename A> struct Traits<std::multimap<K, T, L, A> > : ListTraits<std::pair<K, T> > {};
+    template<typename K, typename T, typename H, typename E, typename A> struct Traits<std::unordered_map<K, T, H, E, A> > : ListTraits<std::pair<K, T> > {};
+    template<typename K, typename T, typename H, typename E, typename A> struct Traits<std::unordered_multimap<K, T, H, E, A> > : ListTraits<std::pair<K, T> > {};
+
+    /** Maps are stored sorted by their keys **/
+    template<typename K, typename T, typename L, typename A>
+    struct Traits<std::map<K, T, L, A> > : ListTraits<std::pair<K, T> >
+    {
+        typedef Map<K, T> View;
+        static View get(const char* base, const char* p) { return View(base, base + slotOffset(p), slotCount(p)); }
+    };
+
+    template<typename K, typename T>
+    struct Traits<std::pair<K, T> >
+    {
+        typedef Pair<K, T> View;
+        static const size_t size = slotSize;
+        static const size_t alignment = slotSize;
+        static View get(const char* base, const char* p) { return View(base, base + slotOffset(p)); }
+        static bool isRoot(uint32_t id) { return id == 0; }
+        static void verify(Bounds& bounds, const char* p)
+        {
+            const size_t second = alignUp(Traits<K>::size, Traits<T>::alignment);
+            verifyRange(bounds, slotOffset(p), 1, second + Traits<T>::size, 1);
+            Traits<K>::verify(bounds, bounds.base + slotOffset(p));
+            Traits<T>::verify(bounds, bounds.base + slotOffset(p) + second);
+        }
+    };
+
+    /** Mirrors readSlot: values wider than a slot are out of line **/
+    template<typename T>
+    inline void verifySlot(Bounds& bounds, const char* slot)
+    {
+        if(Traits<T>::size > slotSize)
+            verifyRange(bounds, slotOffset(slot), 1, Traits<T>::size, 1);
+        else
+            Traits<T>::verify(bounds, slot);
+    }
+
+    /* -- ROOT -- */
+
+    /** Returns a view of the root value of a buffer. Throws if the header is not valid **/
+    template<typename T>
+    inline typename Traits<T>::View root(const char* data, size_t size)
+    {
+        const bool inPlace = std::is_arithmetic<T>::value && (sizeof(T) <= slotSize);
+        if((size < headerSize) || (loadUint32(data) != magic) || !Traits<T>::isRoot(loadUint32(data + 4)) || 
+            (!inPlace && (slotOffset(data + rootSlot) > size)))
+        {
+            throw new FlatException();
+        }
+
+        return readSlot<T>(data, data + rootSlot);
+    }
+
+    /** Checks the whole buffer before its root is read: the offsets and counts of the slots of every 
+    value reachable from the root are checked against the size of the buffer. Throws if they are not 
+    valid, so the views of a verified buffer do not read outside of it. Optional, as it visits the 
+    whole buffer **/
+    template<typename T>
+    inline void verify(const char* data, size_t size)
+    {
+        root<T>(data, size);
+        Bounds bounds = { data, size, size };
+        verifySlot<T>(bounds, data + rootSlot);
+    }
+    template<typename T>
+    inline void verify(const std::string& data)
+    {
+        verify<T>(data.data(), data.size());
+    }
+
+    template<typename T>
+    inline typename Traits<T>::View root(const std::string& data)
+    {
+        return root<T>(data.data(), data.size());
+    }
+}
@@ -0,0 +1,84 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+#include <string.h>
+
+#include <exception>
+
+// Flat Definitions
+namespace Flat
+{
+    /** This exception is thrown when a buffer is not in the flat format, when it is too large
+    to be addressed, or when a wide stream is used **/
+    class FlatException : public std::exception
+    {
+    public:
+      const char* what() const throw() { return "Invalid flat format!\n"; }
+    };
+
+    /* -- LAYOUT -- */
+
+    /** Buffers start with a header: the magic number, the id of the root class and the root slot.
+    The magic number is written in the byte order of the host, so buffers written with another
+    byte order are rejected **/
+    static const uint32_t magic = 0x31465A53; // "SZF1"
+    static const size_t headerSize = 16;
+    static const size_t rootSlot = 8;
+
+    /** Members of a class use one slot each. Strings, containers, classes and scalars wider
+    than a slot are stored out of line, and their slot holds their offset and length **/
+    static const size_t slotSize = 8;
+
+    /** Out of line containers and classes are aligned to this boundary **/
+    static const size_t bodyAlignment = 16;
+
+    constexpr size_t alignUp(size_t value, size_t alignment) 
+    { 
+        return (value + alignment - 1) & ~(alignment - 1); 
+    }
+
+    inline uint32_t loadUint32(const char* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline void storeUint32(char* p, uint32_t value)
+    {
+        memcpy(p, &value, sizeof(value));
+    }
+
+    /** Offset from the beginning of the buffer of an out of line value **/
+    inline uint32_t slotOffset(const char* slot) { return loadUint32(slot); }
+    /** Characters of a string, elements of a container or members of a class **/
+    inline uint32_t slotCount(const char* slot) { return loadUint32(slot + 4); }
+}
@@ -0,0 +1,258 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "Seza.h"
+#include "BinaryDefinitions.h"
+#include "FlatDefinitions.h"
+
+/** Fixed layout format that can be read in place with the accessors of FlatAccessors.h.
+Each member of a class takes one slot of its table, so the member i is at the offset 8 * i.
+Scalars are stored in the byte order of the host, and elements of containers are packed 
+with their natural size and alignment. Offsets are relative to the beginning of the buffer, 
+which has to be aligned to 16 bytes to read it in place **/
+class FlatSerializer : public Seza::SerializerImpl<FlatSerializer>
+{
+public:
+    FlatSerializer() : _classId(0) {}
+
+protected:
+
+    friend class Seza::SerializerImpl<FlatSerializer>;
+
+    /** Values are laid out in the body of their container, and bodies are moved to the buffer
+    once they are complete **/
+    struct Body
+    {
+        Body(bool table, size_t slot) : table(table), slot(slot) {}
+
+        std::string data;
+        /** Values take one slot each **/
+        bool table;
+        /** Position of the slot of the body in its parent **/
+        size_t slot;
+    };
+
+    /** The outermost write lays out the whole buffer, and sends it to the writer when it ends **/
+    class Scope
+    {
+    public:
+        Scope(FlatSerializer& sez) : _sez(sez), _root(sez._bodies.empty()) 
+        { 
+            if(_root) 
+                _sez.start(); 
+        }
+        ~Scope() 
+        { 
+            if(_root) 
+                _sez._bodies.clear(); 
+        }
+        void commit(Seza::Writer& os) 
+        { 
+            if(_root) 
+                _sez.finish(os); 
+        }
+
+    private:
+        FlatSerializer& _sez;
+        bool _root;
+    };
+
+    // null
+    void writeNull(Seza::Writer& os)
+    {
+        Scope scope(*this);
+        place(Flat::slotSize, Flat::slotSize);
+        scope.commit(os);
+    }
+
+    // Values
+    template<typename Type> 
+    void writeValue(Seza::Writer& os, const Type& value)
+    {
+        Scope scope(*this);
+        if(_bodies.back().table && (sizeof(Type) > Flat::slotSize))
+            setSlot(place(Flat::slotSize, Flat::slotSize), append((const char*)&value, sizeof(Type), alignof(Type)), 1);
+        else
+        {
+            size_t position = place(sizeof(Type), alignof(Type));
+            memcpy(&_bodies.back().data[position], &value, sizeof(Type));
+        }
+        scope.commit(os);
+    }
+
+    // Strings
+    /** Strings are followed by a null character, so they can be used as C strings **/
+    template<typename Type>
+    void writeString(Seza::Writer& os, const Type& value)
+    {
+        typedef typename Type::value_type Char;
+
+        Scope scope(*this);
+        size_t offset = append((const char*)value.data(), value.size() * sizeof(Char), alignof(Char));
+        Char terminator = 0;
+        append((const char*)&terminator, sizeof(Char), alignof(Char));
+        setSlot(place(Flat::slotSize, Flat::slotSize), offset, value.size());
+        scope.commit(os);
+    }
+
+    // Arrays
+    template<typename Type> 
+    void writeArray(Seza::Writer& os, const Type* vector, const size_t& size)
+    {
+        Scope scope(*this);
+        open(false);
+        if(Seza::BlockElement<Type>::value)
+            _bodies.back().data.assign((const char*)vector, size * sizeof(Type));
+        else
+        {
+            for(size_t i=0; i<size; ++i)
+                this->write(os, vector[i]);
+        }
+        close(size);
+        scope.commit(os);
+    }
+
+    // STL conatiners
+    template<typename Container>
+    void writeSTLContainer(Seza::Writer& os, const Container& container)
+    {
+        Scope scope(*this);
+        open(false);
+        Seza::Block block;
+        size_t count = 0;
+        if(container.getBlock(block) && !block.trivialLayout) // Packed numbers are their raw bytes
+        {
+            _bodies.back().data.assign((const char*)block.data, block.size * block.elementSize);
+            count = block.size;
+        }
+        else
+        {
+            for(container.begin(); !container.isEnd(); container.next(), ++count)
+                container.serializeElem(this, os);
+        }
+        close(count);
+        scope.commit(os);
+    }
+
+    // Serializable class
+    template<typename Object>
+    void writeSerializable(Seza::Writer& os, const Object& object)
+    {
+        Scope scope(*this);
+        if(_bodies.size() == 1)
+            _classId = Binary::classId(object.getClassName());
+
+        open(true);
+        for(object.begin(); !object.isEnd(); object.next())
+            object.serializeElemValue(this, os);
+        close(object.membersCount());
+        scope.commit(os);
+    }
+
+    // Wide streams
+    void writeNull(std::wostream& os) { throw new Flat::FlatException(); }
+    template<typename Type> void writeValue(std::wostream& os, const Type& value) { throw new Flat::FlatException(); }
+    template<typename Type> void writeString(std::wostream& os, const Type& value) { throw new Flat::FlatException(); }
+    template<typename Type> void writeArray(std::wostream& os, const Type* vector, const size_t& size) { throw new Flat::FlatException(); }
+    template<typename Container> void writeSTLContainer(std::wostream& os, const Container& container) { throw new Flat::FlatException(); }
+    template<typename Object> void writeSerializable(std::wostream& os, const Object& object) { throw new Flat::FlatException(); }
+
+    /* -- LAYOUT -- */
+
+    /** The root value is laid out in the slot of the header **/
+    void start()
+    {
+        _buffer.assign(Flat::headerSize, '\0');
+        _classId = 0;
+        _bodies.push_back(Body(true, 0));
+    }
+
+    void finish(Seza::Writer& os)
+    {
+        Flat::storeUint32(&_buffer[0], Flat::magic);
+        Flat::storeUint32(&_buffer[4], _classId);
+        memcpy(&_buffer[Flat::rootSlot], _bodies.back().data.data(), Flat::slotSize);
+        os.write(_buffer.data(), _buffer.size());
+    }
+
+    /** Reserves room for a value in the current body. Returns its position **/
+    size_t place(size_t size, size_t alignment)
+    {
+        Body& body = _bodies.back();
+        if(body.table)
+            size = alignment = Flat::slotSize;
+
+        size_t position = Flat::alignUp(body.data.size(), alignment);
+        body.data.resize(position + size, '\0');
+        return position;
+    }
+
+    /** Appends out of line data to the buffer. Returns its offset **/
+    size_t append(const char* data, size_t size, size_t alignment)
+    {
+        size_t offset = Flat::alignUp(_buffer.size(), alignment);
+        if(offset + size > 0xFFFFFFFF)
+            throw new Flat::FlatException();
+
+        _buffer.resize(offset);
+        _buffer.append(data, size);
+        return offset;
+    }
+
+    void setSlot(size_t position, size_t offset, size_t count)
+    {
+        char* slot = &_bodies.back().data[position];
+        Flat::storeUint32(slot, (uint32_t)offset);
+        Flat::storeUint32(slot + 4, (uint32_t)count);
+    }
+
+    void open(bool table)
+    {
+        size_t slot = place(Flat::slotSize, Flat::slotSize);
+        _bodies.push_back(Body(table, slot));
+    }
+
+    void close(size_t count)
+    {
+        size_t offset = append(_bodies.back().data.data(), _bodies.back().data.size(), Flat::bodyAlignment);
+        size_t slot = _bodies.back().slot;
+        _bodies.pop_back();
+        setSlot(slot, offset, count);
+    }
+
+    std::string _buffer;
+    std::vector<Body> _bodies;
+    uint32_t _classId;
+};
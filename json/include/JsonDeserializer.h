@@ -28,15 +28,18 @@
  
  #pragma once;
 
+#include <algorithm>
 #include <iomanip>
 
 #include "Seza.h"
+#include "SezaParse.h"
 #include "JsonDefinitions.h"
+#include "JsonStrings.h"
 
 class JsonException : std::exception 
 {
 public:
-  const char* what() const { return "Invalid JSON format!\n"; }
+  const char* what() const throw() { return "Invalid JSON format!\n"; }
 };
 
 class JsonDeserializer : public Seza::DeserializerImpl<JsonDeserializer>
@@ -45,14 +48,12 @@ protected:
     friend class Seza::DeserializerImpl<JsonDeserializer>;
 
     // null
-    void readNull(std::istream& is)
+    void readNull(Seza::Reader& is)
     {
-        char value[5];
-        is.read(value, 4);
-        value[4] = '\0';
-
-        if(std::string(value) != "null")
+        skipWhitespace(is);
+        if(!is.require(4) || (memcmp(is.cursor(), "null", 4) != 0))
             throw JsonException();
+        is.skip(4);
     }
 
     void readNull(std::wistream& is)
@@ -72,38 +73,343 @@ protected:
         is >> std::boolalpha >> value;
     }
 
+    void readValue(Seza::Reader& is, bool& value)
+    {
+        skipWhitespace(is);
+        if(is.require(4) && (memcmp(is.cursor(), "true", 4) == 0))
+        {
+            value = true;
+            is.skip(4);
+        }
+        else if(is.require(5) && (memcmp(is.cursor(), "false", 5) == 0))
+        {
+            value = false;
+            is.skip(5);
+        }
+        else
+            throw new JsonException();
+    }
+
+    void readValue(Seza::Reader& is, char& value)
+    {
+        int c = skipWhitespace(is);
+        if(c == Seza::Reader::eof)
+            throw new JsonException();
+        value = (char)c;
+        is.skip(1);
+    }
+
+    void readValue(Seza::Reader& is, unsigned char& value)
+    {
+        char c;
+        readValue(is, c);
+        value = (unsigned char)c;
+    }
+
+    template<typename S> void readValue(S& is, short& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, unsigned short& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, int& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, unsigned int& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, long& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, unsigned long& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, long long& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, unsigned long long& value) { readInteger(is, value); }
+    template<typename S> void readValue(S& is, float& value) { readFloat(is, value); }
+    template<typename S> void readValue(S& is, double& value) { readFloat(is, value); }
+    template<typename S> void readValue(S& is, long double& value) { readFloat(is, value); }
+
+    // Integers
+    /** Reads the characters of an integer straight from the stream buffer and converts them
+    with the SWAR parser **/
+    template<typename Stream, typename Int>
+    void readInteger(Stream& is, Int& value)
+    {
+        char token[32];
+        std::string longToken;
+        size_t length = readNumber(is, token, sizeof(token), longToken);
+
+        const char* begin = (length > sizeof(token)) ? longToken.data() : token;
+        convertInteger(begin, begin + length, value);
+    }
+
+    /** Readers are parsed in place **/
+    template<typename Int>
+    void readInteger(Seza::Reader& is, Int& value)
+    {
+        const char* end = readNumber(is);
+        convertInteger(is.cursor(), end, value);
+        is.seek(end);
+    }
+
+    template<typename Int>
+    void convertInteger(const char* begin, const char* end, Int& value)
+    {
+        if(Seza::parseInteger(begin, end, value) != end)
+            throw new JsonException();
+    }
+
+    // Floating point numbers
+    /** Reads the characters of a number straight from the stream buffer and converts them
+    with the exact parser **/
+    template<typename Stream, typename Float>
+    void readFloat(Stream& is, Float& value)
+    {
+        char token[128];
+        std::string longToken;
+        size_t length = readNumber(is, token, sizeof(token), longToken);
+
+        const char* begin = (length > sizeof(token)) ? longToken.data() : token;
+        convertFloat(begin, begin + length, value);
+    }
+
+    /** Readers are parsed in place **/
+    template<typename Float>
+    void readFloat(Seza::Reader& is, Float& value)
+    {
+        const char* end = readNumber(is);
+        convertFloat(is.cursor(), end, value);
+        is.seek(end);
+    }
+
+    /** NaN and infinite values are written as null **/
+    template<typename Float>
+    void convertFloat(const char* begin, const char* end, Float& value)
+    {
+        if((end - begin == 4) && (memcmp(begin, "null", 4) == 0))
+        {
+            value = std::numeric_limits<Float>::quiet_NaN();
+            return;
+        }
+
+        if(Seza::parseFloat(begin, end, value) != end)
+            throw new JsonException();
+    }
+
+    /** Skips whitespace and returns the end of the characters that may belong to a number. They are
+    all made contiguous in the reader buffer, starting at its cursor **/
+    const char* readNumber(Seza::Reader& is)
+    {
+        skipWhitespace(is);
+
+        size_t length = 0;
+        bool more = true;
+        while(true)
+        {
+            const char* p = is.cursor() + length;
+            while((p != is.end()) && isNumberChar(*p))
+                ++p;
+            length = p - is.cursor();
+
+            if((p != is.end()) || !more)
+                return p;
+            more = is.require(length + 1);
+        }
+    }
+
+    /** Skips whitespace and copies the characters that may belong to a number into token. If they 
+    are more than capacity, all of them are copied into longToken. Returns the count of characters **/
+    template<typename Stream>
+    size_t readNumber(Stream& is, char* token, const size_t& capacity, std::string& longToken)
+    {
+        typedef typename Stream::traits_type Traits;
+        typename Traits::int_type c;
+        std::basic_streambuf<typename Stream::char_type, Traits>* buffer = is.rdbuf();
+
+        c = buffer->sgetc();
+        while(!Traits::eq_int_type(c, Traits::eof()) && isWhitespace(c)) // Skip whitespace
+            c = buffer->snextc();
+
+        size_t length = 0;
+        for(; !Traits::eq_int_type(c, Traits::eof()) && isNumberChar(c); c = buffer->snextc())
+        {
+            if(length == capacity)
+                longToken.assign(token, length);
+            if(length < capacity)
+                token[length] = (char)c;
+            else
+                longToken.push_back((char)c);
+            ++length;
+        }
+
+        if(Traits::eq_int_type(c, Traits::eof()))
+            is.setstate(std::ios_base::eofbit);
+
+        return length;
+    }
+
+    /** Skips whitespace and returns the next byte without consuming it. After whitespace, the 
+    next byte is always a mark of the structural index **/
+    static int skipWhitespace(Seza::Reader& is)
+    {
+        int c = is.peek();
+        if(is.indexed() && (c != Seza::Reader::eof) && isWhitespace(c)) // The next significant byte is indexed
+            is.skipToMark();
+
+        while(((c = is.peek()) != Seza::Reader::eof) && isWhitespace(c))
+            is.skip(1);
+        return c;
+    }
+
+    /** Skips whitespace and consumes the next byte **/
+    static int nextChar(Seza::Reader& is)
+    {
+        int c = skipWhitespace(is);
+        if(c != Seza::Reader::eof)
+            is.skip(1);
+        return c;
+    }
+
+    /** Returns the count of elements of the array whose opening bracket has been read, as counted 
+    when the index was built, or 0 if the index does not have it. Only a hint to reserve them **/
+    static size_t countElements(Seza::Reader& is)
+    {
+        size_t count = is.countAt(is.nextMark()[-1]); // The opening bracket is the last mark before the cursor
+        return (count != Seza::Reader::unknownCount) ? count : 0;
+    }
+
+    /** Searches the beginning of a string, leaving the reader on the quotation mark **/
+    static void skipToQuotationMark(Seza::Reader& is)
+    {
+        int c;
+        skipWhitespace(is);
+        while((c = is.peek()) != JSON::quotationMark)
+        {
+            if(c == Seza::Reader::eof)
+                throw new JsonException();
+            is.skip(1);
+        }
+    }
+
+    template<typename Int>
+    static bool isWhitespace(Int c)
+    {
+        return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+    }
+
+    template<typename Int>
+    static bool isNumberChar(Int c)
+    {
+        return ((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == '.') || 
+            (c == 'e') || (c == 'E') || (c == 'n') || (c == 'u') || (c == 'l');
+    }
+
     // String
-    template<typename T> 
-    void readString(std::istream& is, T& value)
+    /** The raw content is taken from the stream with its own buffered search of the quotation marks,
+    and then the escape sequences are decoded in place in a single vectorized pass **/
+    template<typename Stream, typename T> 
+    void readString(Stream& is, T& value)
     {
-        while(is.peek() != JSON::quotationMark) // Search begin string
-            is.ignore(1);
-        is.ignore(1);
-        
-        std::getline(is, value, JSON::quotationMark); // Copy until quotation mark
+        typedef typename Stream::traits_type Traits;
+        const typename Stream::char_type quotationMark = (typename Stream::char_type)JSON::quotationMark;
+
+        is.ignore(std::numeric_limits<std::streamsize>::max(), Traits::to_int_type(quotationMark)); // Search begin string
+        if(is.eof())
+            throw new JsonException();
+
+        std::getline(is, value, quotationMark); // Copy until quotation mark
+        while(!is.eof() && JSON::endsInEscape(value)) // The quotation mark was escaped
+        {
+            T segment;
+            std::getline(is, segment, quotationMark);
+            value.push_back(quotationMark);
+            value.append(segment);
+        }
+        if(is.eof())
+            throw new JsonException();
+
+        size_t length = JSON::unescape(&value[0], value.size());
+        if(length == std::string::npos)
+            throw new JsonException();
+        value.resize(length);
     }
 
-    template<typename T> 
-    void readString(std::wistream& is, T& value)
+    /** Readers are decoded in a single pass straight into value. Plain runs are found with the 
+    vectorized scanner and appended in blocks **/
+    template<typename A>
+    void readString(Seza::Reader& is, std::basic_string<char, std::char_traits<char>, A>& value)
     {
-        while(is.peek() != JSON::quotationMark) // Search begin string
-            is.ignore(1);
-        is.ignore(1);
-        
-        std::getline(is, value, Seza::convertToWChar(JSON::quotationMark)); // Copy until quotation mark
+        skipToQuotationMark(is);
+        is.skip(1);
+        value.clear();
+        if(is.indexed()) // The contents end before the next mark
+        {
+            const uint32_t* mark = is.nextMark();
+            if(mark != is.marksEnd())
+                value.reserve((size_t)(is.indexBase() + *mark - is.cursor()));
+        }
+
+        while(true)
+        {
+            if(!is.fill())
+                throw new JsonException();
+
+            const char* special = JSON::findSpecial(is.cursor(), is.end());
+            value.append(is.cursor(), special);
+            is.seek(special);
+            if(special == is.end())
+                continue;
+
+            if(*special == JSON::quotationMark)
+                break;
+            if(*special != '\\') // Control character
+                throw new JsonException();
+
+            is.require(12); // The longest escape is a surrogate pair
+            char decoded[4];
+            char* out = decoded;
+            const char* next = JSON::unescapeSequence(is.cursor() + 1, is.end(), out);
+            if(next == 0)
+                throw new JsonException();
+            value.append(decoded, out);
+            is.seek(next);
+        }
+        is.skip(1);
+    }
+
+    /** Wide strings are read as UTF-8, the encoding used by the serializer **/
+    void readString(Seza::Reader& is, std::wstring& value)
+    {
+        std::string tmp;
+        readString(is, tmp);
+        JSON::decodeUtf8(tmp.data(), tmp.size(), value);
+    }
+
+    // Member names
+    template<typename Stream>
+    const Seza::MemberDescriptor* readName(Stream& is, const Seza::MemberTable& members)
+    {
+        char name[Seza::MemberTable::maxNameLength];
+        size_t length = readToken(is, name, sizeof(name));
+
+        if(length > sizeof(name))
+            return 0;
+
+        return members.find(name, length);
+    }
+
+    const Seza::MemberDescriptor* readName(Seza::Reader& is, const Seza::MemberTable& members)
+    {
+        size_t length;
+        const char* name = readToken(is, length);
+
+        return members.find(name, length);
     }
 
     // Arrays
     template<typename T> 
-    size_t readArray(std::istream& is, T* vector, const size_t& size)
+    size_t readArray(Seza::Reader& is, T* vector, const size_t& size)
     {
         size_t length;
-        char c;
-
-        is >> c;
+        int c = nextChar(is);
         if(c != JSON::beginArray)
             throw new JsonException();
 
+        if(skipWhitespace(is) == JSON::endArray) // Empty array
+        {
+            is.skip(1);
+            return 0;
+        }
+
         c = JSON::elementSeparator;
         
         for(length = 0; ((length < size) && (c != JSON::endArray)); ++length)
@@ -112,7 +418,7 @@ protected:
                 throw new JsonException();
 
             this->read(is, vector[length]);
-            is >> c;
+            c = nextChar(is);
         }
 
         if(c != JSON::endArray)
@@ -131,6 +437,12 @@ protected:
         if(c != JSON::beginArray)
             throw new JsonException();
 
+        if((is >> std::ws).peek() == JSON::endArray) // Empty array
+        {
+            is.ignore(1);
+            return 0;
+        }
+
         c = JSON::elementSeparator;
         
         for(length = 0; ((length < size) && (c != JSON::endArray)); ++length)
@@ -149,14 +461,24 @@ protected:
     }
     
     // STL containers
-    void readSTLContainer(std::istream& is, Seza::SerializableSTLContainer& container)
+    template<typename Container>
+    void readSTLContainer(Seza::Reader& is, Container& container)
     {
-        char c;
-        is >> c;
+        this->checkStack();
+        int c = nextChar(is);
 
         if(c != JSON::beginArray)
             throw new JsonException();
 
+        if(skipWhitespace(is) == JSON::endArray) // Empty container
+        {
+            is.skip(1);
+            return;
+        }
+
+        if(is.indexed() && container.isReservable())
+            container.reserve(countElements(is));
+
         c = JSON::elementSeparator;
 
         while((c != JSON::endArray) && (c != EOF))
@@ -165,14 +487,15 @@ protected:
                 throw new JsonException();
 
             container.deserializeElem(this, is);
-            is >> c;
+            c = nextChar(is);
         }
 
         if(c != JSON::endArray)
             throw new JsonException();
     }
 
-    void readSTLContainer(std::wistream& is, Seza::SerializableSTLContainer& container)
+    template<typename Container>
+    void readSTLContainer(std::wistream& is, Container& container)
     {
         wchar_t c;
         is >> c;
@@ -180,6 +503,12 @@ protected:
         if(c != JSON::beginArray)
             throw new JsonException();
 
+        if((is >> std::ws).peek() == JSON::endArray) // Empty container
+        {
+            is.ignore(1);
+            return;
+        }
+
         c = JSON::elementSeparator;
 
         while((c != JSON::endArray) && (c != EOF))
@@ -195,31 +524,27 @@ protected:
             throw new JsonException();
     }
     // Serializable class
-    void readSerializable(std::istream& is, const Seza::Serializable& object)
+    template<typename Object>
+    void readSerializable(Seza::Reader& is, const Object& object)
     {
-        char c;
-        is >> c;
+        this->checkStack();
+        int c = nextChar(is);
 
         if(c != JSON::beginObject)
             throw new JsonException();
 
-        std::string className;
-        readString(is, className);
-
-        if(className != "_className_")
+        if(!readToken(is, "_className_"))
             throw new JsonException();
 
-        is >> c;
+        c = nextChar(is);
         if(c != JSON::valueSeparator)
             throw new JsonException();
 
-        readString(is, className);
-
-        if(className != object.getClassName())
+        if(!readToken(is, object.getClassName()))
             throw new JsonException();
 
         c = JSON::elementSeparator;
-        is >> c;
+        c = nextChar(is);
 
         while((c != JSON::endObject) && (c != EOF))
         {
@@ -229,19 +554,20 @@ protected:
             if(!object.deserializeElemName(this, is))
                 throw new JsonException();
 
-            is >> c;
+            c = nextChar(is);
             if(c != JSON::valueSeparator)
                 throw new JsonException();
 
             object.deserializeElemValue(this, is);
-            is >> c;
+            c = nextChar(is);
         }
 
         if(c != JSON::endObject)
             throw new JsonException();
     }
 
-    void readSerializable(std::wistream& is, const Seza::Serializable& object)
+    template<typename Object>
+    void readSerializable(std::wistream& is, const Object& object)
     {
         wchar_t c;
         is >> c;
@@ -249,19 +575,14 @@ protected:
         if(c != JSON::beginObject)
             throw new JsonException();
 
-        std::wstring className;
-        readString(is, className);
-
-        if(className != L"_className_")
+        if(!readToken(is, "_className_"))
             throw new JsonException();
 
         is >> c;
         if(c != JSON::valueSeparator)
             throw new JsonException();
 
-        readString(is, className);
-
-        if(className != Seza::convertToWString(object.getClassName()))
+        if(!readToken(is, object.getClassName()))
             throw new JsonException();
 
         c = JSON::elementSeparator;
@@ -286,4 +607,82 @@ protected:
         if(c != JSON::endObject)
             throw new JsonException();
     }
+
+    // Quoted tokens
+    /** Reads a quoted token into buffer without unescaping it. Returns the length of the token, 
+    which is greater than capacity if it did not fit. Wide tokens with characters out of ASCII are 
+    not narrowed, so they cannot alias a member name, and are returned as not fitting **/
+    template<typename Stream>
+    size_t readToken(Stream& is, char* buffer, const size_t& capacity)
+    {
+        typedef typename Stream::traits_type Traits;
+        typename Traits::int_type c;
+        const bool wide = (sizeof(typename Stream::char_type) > 1);
+        bool ascii = true;
+
+        while((c = is.peek()) != JSON::quotationMark) // Search begin string
+        {
+            if(Traits::eq_int_type(c, Traits::eof()))
+                throw new JsonException();
+            is.ignore(1);
+        }
+        is.ignore(1);
+
+        size_t length = 0;
+        while((c = is.rdbuf()->sbumpc()) != JSON::quotationMark) // Copy until quotation mark
+        {
+            if(Traits::eq_int_type(c, Traits::eof()))
+                throw new JsonException();
+            if(wide && ((c < 0) || (c > 0x7F)))
+                ascii = false;
+            if(length < capacity)
+                buffer[length] = (char)Traits::to_char_type(c);
+            ++length;
+        }
+
+        return ascii ? length : std::max(length, capacity + 1);
+    }
+
+    /** Finds a quoted token in the reader buffer without unescaping it. The token is valid until 
+    the next read **/
+    const char* readToken(Seza::Reader& is, size_t& length)
+    {
+        skipToQuotationMark(is);
+        is.skip(1);
+
+        length = 0;
+        while(true)
+        {
+            const char* end = (const char*)memchr(is.cursor() + length, JSON::quotationMark, is.available() - length);
+            if(end != 0)
+            {
+                const char* token = is.cursor();
+                length = end - token;
+                is.seek(end + 1);
+                return token;
+            }
+
+            length = is.available();
+            if(!is.require(length + 1))
+                throw new JsonException();
+        }
+    }
+
+    bool readToken(Seza::Reader& is, const char* expected)
+    {
+        size_t length;
+        const char* token = readToken(is, length);
+
+        return (strlen(expected) == length) && (memcmp(token, expected, length) == 0);
+    }
+
+    /** Reads a quoted token and checks that it is equal to expected **/
+    template<typename Stream>
+    bool readToken(Stream& is, const char* expected)
+    {
+        char token[Seza::MemberTable::maxNameLength];
+        size_t length = readToken(is, token, sizeof(token));
+
+        return ((length <= sizeof(token)) && (strlen(expected) == length) && (memcmp(token, expected, length) == 0));
+    }
 };
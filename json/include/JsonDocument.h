@@ -0,0 +1,284 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include <string>
+
+#include "SezaReader.h"
+#include "JsonDefinitions.h"
+#include "JsonDeserializer.h"
+#include "JsonStrings.h"
+#include "JsonStructuralIndex.h"
+
+// JSON on demand documents
+namespace JSON
+{
+    class Value;
+
+    /** Read only view of a JSON text with its structural index. Values are found on demand: 
+    the subtrees that are not visited are skipped over the index without being decoded or validated **/
+    class Document
+    {
+    public:
+        Document(const char* data, size_t size) :
+            _data(data),
+            _size(size)
+        {
+            buildIndex();
+        }
+        Document(const std::string& data) :
+            _data(data.data()),
+            _size(data.size())
+        {
+            buildIndex();
+        }
+        /** The document keeps a pointer to the text, it can not be built from a temporary **/
+        Document(std::string&&) = delete;
+
+        /** Returns the top level value **/
+        Value root() const;
+
+    private:
+        friend class Value;
+
+        static const size_t npos = (size_t)-1;
+
+        Document(const Document&);
+        Document& operator=(const Document&);
+
+        void buildIndex()
+        {
+            if(!_index.build(_data, _size) || (_index.size() == 0))
+                throw new JsonException();
+        }
+
+        /** Returns the first byte of the value at mark **/
+        char at(size_t mark) const { return (mark < _index.size()) ? _data[_index[mark]] : '\0'; }
+        /** Returns the position of the mark, or the end of the text **/
+        const char* position(size_t mark) const { return _data + ((mark < _index.size()) ? _index[mark] : _size); }
+
+        /** Returns the mark after the value at mark, skipping its contents **/
+        size_t skip(size_t mark) const
+        {
+            char c = at(mark);
+            if((c != beginObject) && (c != beginArray))
+                return mark + 1;
+
+            size_t depth = 0;
+            for(; mark < _index.size(); ++mark)
+            {
+                c = _data[_index[mark]];
+                if((c == beginObject) || (c == beginArray))
+                    ++depth;
+                else if(((c == endObject) || (c == endArray)) && (--depth == 0))
+                    return mark + 1;
+            }
+            throw new JsonException();
+        }
+
+        /** Returns the mark of the member value called name in the object at mark, or npos **/
+        size_t member(size_t mark, const char* name, size_t length) const
+        {
+            if(at(mark) != beginObject)
+                throw new JsonException();
+
+            ++mark;
+            while(at(mark) == quotationMark)
+            {
+                if(at(mark + 1) != valueSeparator)
+                    throw new JsonException();
+
+                if(isName(mark, name, length))
+                    return mark + 2;
+
+                mark = skip(mark + 2);
+                if(at(mark) != elementSeparator)
+                    break;
+                ++mark;
+            }
+
+            if(at(mark) != endObject)
+                throw new JsonException();
+            return npos;
+        }
+
+        /** Returns the mark of the element index in the array at mark, or npos **/
+        size_t element(size_t mark, size_t index) const
+        {
+            if(at(mark) != beginArray)
+                throw new JsonException();
+
+            ++mark;
+            if(at(mark) == endArray)
+                return npos;
+
+            for(size_t i = 0; i < index; ++i)
+            {
+                mark = skip(mark);
+                if(at(mark) == endArray)
+                    return npos;
+                if(at(mark) != elementSeparator)
+                    throw new JsonException();
+                ++mark;
+            }
+            return mark;
+        }
+
+        /** Returns the count of elements or members of the container at mark **/
+        size_t count(size_t mark) const
+        {
+            char c = at(mark);
+            if((c != beginObject) && (c != beginArray))
+                throw new JsonException();
+
+            size_t result = 0;
+            ++mark;
+            while((at(mark) != endObject) && (at(mark) != endArray))
+            {
+                mark = skip((c == beginObject) ? mark + 2 : mark);
+                ++result;
+                if(at(mark) != elementSeparator)
+                    break;
+                ++mark;
+            }
+            return result;
+        }
+
+        /** Compares the key at mark with name. Keys with escape sequences are decoded first **/
+        bool isName(size_t mark, const char* name, size_t length) const
+        {
+            const char* begin = position(mark) + 1;
+            const char* end = position(mark + 1);
+            while(*--end != quotationMark) // Closing quotation mark before the separator
+                ;
+
+            if(memchr(begin, '\\', end - begin) == 0)
+                return ((size_t)(end - begin) == length) && (memcmp(begin, name, length) == 0);
+
+            std::string key(begin, end);
+            size_t keyLength = unescape(&key[0], key.size());
+            return (keyLength == length) && (memcmp(key.data(), name, length) == 0);
+        }
+
+        const char* _data;
+        size_t _size;
+        StructuralIndex _index;
+    };
+
+    /** Cursor to a value of a document. Values are only decoded when they are read **/
+    class Value
+    {
+    public:
+        Value() : _document(0), _mark(Document::npos) {}
+
+        /** Returns false for the members and elements not found **/
+        bool exists() const { return _mark != Document::npos; }
+        bool isObject() const { return first() == beginObject; }
+        bool isArray() const { return first() == beginArray; }
+        bool isString() const { return first() == quotationMark; }
+        bool isNull() const { return first() == 'n'; }
+        bool isBool() const { return (first() == 't') || (first() == 'f'); }
+        bool isNumber() const { return (first() == '-') || ((first() >= '0') && (first() <= '9')); }
+
+        /** Returns the member called name of an object. Throws if it does not exist **/
+        Value operator[](const char* name) const { return get(find(name, strlen(name))); }
+        Value operator[](const std::string& name) const { return get(find(name.data(), name.size())); }
+        /** Returns the element index of an array. Throws if it does not exist **/
+        Value operator[](size_t index) const { return get(at(index)); }
+        Value operator[](int index) const { return get(at((size_t)index)); }
+
+        /** Returns the member called name of an object, or a value that does not exist **/
+        Value find(const char* name, size_t length) const { return Value(_document, exists() ? _document->member(_mark, name, length) : Document::npos); }
+        Value find(const std::string& name) const { return find(name.data(), name.size()); }
+        /** Returns the element index of an array, or a value that does not exist **/
+        Value at(size_t index) const { return Value(_document, exists() ? _document->element(_mark, index) : Document::npos); }
+
+        /** Returns the count of elements of an array or members of an object **/
+        size_t size() const { return _document->count(check()); }
+
+        /** Returns the text of the value, with any whitespace after it **/
+        const char* data() const { return _document->position(check()); }
+        size_t length() const
+        {
+            const char* begin = data();
+            return _document->position(_document->skip(_mark)) - begin;
+        }
+
+        /** Decodes the value with the deserializer **/
+        template<typename T>
+        void read(Seza::Deserializer& deserializer, T& value) const
+        {
+            Seza::BufferReader reader(data(), length());
+            deserializer.read(reader, value);
+        }
+        template<typename T>
+        void read(T& value) const
+        {
+            JsonDeserializer deserializer;
+            read(deserializer, value);
+        }
+        template<typename T>
+        T as() const
+        {
+            T value = T();
+            read(value);
+            return value;
+        }
+
+    private:
+        friend class Document;
+
+        Value(const Document* document, size_t mark) : _document(document), _mark(mark) {}
+
+        char first() const { return exists() ? _document->at(_mark) : '\0'; }
+
+        size_t check() const
+        {
+            if(!exists())
+                throw new JsonException();
+            return _mark;
+        }
+
+        static Value get(const Value& value)
+        {
+            value.check();
+            return value;
+        }
+
+        const Document* _document;
+        size_t _mark;
+    };
+
+    inline Value Document::root() const
+    {
+        return Value(this, 0);
+    }
+}
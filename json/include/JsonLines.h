@@ -0,0 +1,366 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SezaReader.h"
+#include "SezaWriter.h"
+#include "JsonDeserializer.h"
+#include "JsonSerializer.h"
+
+// JSON Lines batches: one value per line, read and written in parallel
+namespace JSON
+{
+    /** Error of a line that could not be read **/
+    struct LineError
+    {
+        /** Number of the line in the input, from 1 **/
+        size_t line;
+        std::string message;
+    };
+
+    /** Bytes of input read by a thread at a time, and lines written by a thread at a time. Enough to 
+    amortize taking them, and few enough to balance the threads when some lines are longer **/
+    const size_t bytesPerTask = 1 << 16;
+    const size_t linesPerTask = 256;
+    /** Tasks a writing thread may complete ahead of the lines written, per thread **/
+    const size_t tasksAheadPerThread = 4;
+
+    /* -- WORKERS -- */
+
+    /** Threads running the tasks [0, count), taken in order from a shared counter. The first exception 
+    thrown by a task stops the workers, and it is rethrown by join. The threads live for one batch: 
+    a batch is long enough to amortize starting them **/
+    class Workers
+    {
+    public:
+        /** By default there is a thread per hardware thread **/
+        template<typename Task>
+        Workers(size_t count, size_t threads, Task task) :
+            _count(count),
+            _next(0),
+            _failed(false)
+        {
+            if(threads == 0)
+                threads = std::thread::hardware_concurrency();
+            threads = std::max<size_t>(1, std::min(threads, count));
+            try
+            {
+                for(size_t i = 0; i < threads; ++i)
+                    _threads.emplace_back([this, task]() { run(task); });
+            }
+            catch(...)
+            {
+                // The threads started are joined before they are destroyed
+                _failed = true;
+                wait();
+                throw;
+            }
+        }
+        ~Workers() { wait(); }
+
+        bool failed() const { return _failed; }
+
+        /** Waits for the tasks **/
+        void join()
+        {
+            wait();
+            if(_error)
+                std::rethrow_exception(_error);
+        }
+
+    private:
+        Workers(const Workers&);
+        Workers& operator=(const Workers&);
+
+        template<typename Task>
+        void run(Task task)
+        {
+            try
+            {
+                size_t index;
+                while(!_failed && ((index = _next++) < _count))
+                    task(index);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if(!_error)
+                    _error = std::current_exception();
+                _failed = true;
+            }
+        }
+
+        void wait()
+        {
+            for(size_t i = 0; i < _threads.size(); ++i)
+            {
+                if(_threads[i].joinable())
+                    _threads[i].join();
+            }
+        }
+
+        size_t _count;
+        std::atomic<size_t> _next;
+        std::atomic<bool> _failed;
+        std::mutex _mutex;
+        std::exception_ptr _error;
+        std::vector<std::thread> _threads;
+    };
+
+    /* -- READING -- */
+
+    inline bool isBlank(const char* begin, const char* end)
+    {
+        for(; begin != end; ++begin)
+        {
+            if((*begin != ' ') && (*begin != '\t') && (*begin != '\r'))
+                return false;
+        }
+        return true;
+    }
+
+    /** Reads the value of a line. Returns the error message, or an empty string **/
+    template<typename T>
+    inline std::string readLine(JsonDeserializer& deserializer, const char* begin, const char* end, T& value)
+    {
+        try
+        {
+            Seza::BufferReader reader(begin, (size_t)(end - begin));
+            deserializer.read(reader, value);
+            if(!isBlank(reader.cursor(), reader.end()))
+                return "Unexpected characters after the value!\n";
+            return std::string();
+        }
+        catch(JsonException* e)
+        {
+            std::string message = e->what();
+            delete e;
+            return message;
+        }
+        catch(const JsonException& e)
+        {
+            return e.what();
+        }
+        catch(const std::exception& e)
+        {
+            return e.what();
+        }
+        catch(...)
+        {
+            return "Unknown error!\n";
+        }
+    }
+
+    /** Start of the first line beginning at or after position **/
+    inline const char* lineStart(const char* data, const char* end, const char* position)
+    {
+        if((position <= data) || (position[-1] == '\n'))
+            return position;
+        const char* feed = (const char*)memchr(position, '\n', (size_t)(end - position));
+        return (feed != 0) ? feed + 1 : end;
+    }
+
+    /** Values and errors of the lines read by a task. Errors are numbered from the first line of the task **/
+    template<typename T>
+    struct LinesTask
+    {
+        LinesTask() : lines(0) {}
+
+        std::vector<T> values;
+        std::vector<LineError> errors;
+        size_t lines;
+    };
+
+    /** Reads the values of the lines of the input, split at the line feeds, and appends them to 
+    records in the order of the lines. Blank lines are skipped. Each task reads the lines beginning in 
+    its bytes of the input, and the values are moved to records in the order of the tasks. The lines 
+    that cannot be read are returned as errors instead of being appended **/
+    template<typename T>
+    inline std::vector<LineError> readLines(const char* data, size_t size, std::vector<T>& records, size_t threads = 0)
+    {
+        const char* end = data + size;
+        std::vector<LinesTask<T> > tasks((size + bytesPerTask - 1) / bytesPerTask);
+        Workers workers(tasks.size(), threads, [&](size_t index)
+        {
+            LinesTask<T>& task = tasks[index];
+            const char* last = lineStart(data, end, data + std::min(size, (index + 1) * bytesPerTask));
+            JsonDeserializer deserializer;
+            for(const char* begin = lineStart(data, end, data + index * bytesPerTask); begin < last; ++task.lines)
+            {
+                const char* feed = (const char*)memchr(begin, '\n', (size_t)(last - begin));
+                if(feed == 0)
+                    feed = last;
+                if(!isBlank(begin, feed))
+                {
+                    task.values.emplace_back();
+                    std::string message = readLine(deserializer, begin, feed, task.values.back());
+                    if(!message.empty())
+                    {
+                        task.values.pop_back();
+                        LineError error = { task.lines, message };
+                        task.errors.push_back(error);
+                    }
+                }
+                begin = feed + 1;
+            }
+        });
+        workers.join();
+
+        size_t count = 0;
+        for(size_t i = 0; i < tasks.size(); ++i)
+            count += tasks[i].values.size();
+        records.reserve(records.size() + count);
+
+        std::vector<LineError> errors;
+        size_t number = 1;
+        for(size_t i = 0; i < tasks.size(); ++i)
+        {
+            records.insert(records.end(), std::make_move_iterator(tasks[i].values.begin()), 
+                std::make_move_iterator(tasks[i].values.end()));
+            std::vector<T>().swap(tasks[i].values);
+            for(size_t j = 0; j < tasks[i].errors.size(); ++j)
+            {
+                errors.push_back(tasks[i].errors[j]);
+                errors.back().line += number;
+            }
+            number += tasks[i].lines;
+        }
+        return errors;
+    }
+    template<typename T>
+    inline std::vector<LineError> readLines(const std::string& data, std::vector<T>& records, size_t threads = 0)
+    {
+        return readLines(data.data(), data.size(), records, threads);
+    }
+    /** The bytes available in a buffer, like a mapped file **/
+    template<typename T>
+    inline std::vector<LineError> readLines(const Seza::BufferReader& reader, std::vector<T>& records, size_t threads = 0)
+    {
+        return readLines(reader.cursor(), reader.available(), records, threads);
+    }
+
+    /* -- WRITING -- */
+
+    /** Writes the records as JSON Lines. The lines are formatted in parallel, and the thread that 
+    completes the next lines in order writes them. Threads do not format more than tasksAheadPerThread 
+    tasks per thread ahead of the lines written, so the lines kept in memory are bounded when the 
+    writer is slower than the formatting **/
+    template<typename C>
+    inline void writeLines(Seza::Writer& os, const C& records, size_t threads = 0)
+    {
+        std::vector<typename C::const_iterator> starts;
+        size_t count = 0;
+        for(typename C::const_iterator it = records.begin(); it != records.end(); ++it, ++count)
+        {
+            if(count % linesPerTask == 0)
+                starts.push_back(it);
+        }
+
+        if(threads == 0)
+            threads = std::thread::hardware_concurrency();
+        const size_t ahead = std::max<size_t>(1, threads) * tasksAheadPerThread;
+
+        std::vector<std::string> outputs(starts.size());
+        std::vector<char> ready(starts.size(), 0);
+        size_t written = 0;
+        bool failed = false;
+        std::mutex mutex;
+        std::condition_variable advanced; // Notified when written advances or a task fails
+        Workers workers(starts.size(), threads, [&](size_t task)
+        {
+            // The tasks before are taken by running threads, so the next one to write always runs. The 
+            // wait is timed, the untimed one needs a newer libstdc++ than some of the ones it runs with
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                while((task >= written + ahead) && !failed)
+                    advanced.wait_for(lock, std::chrono::milliseconds(100));
+                if(failed)
+                    return;
+            }
+
+            try
+            {
+                {
+                    JsonSerializer serializer;
+                    Seza::StringWriter writer(outputs[task]);
+                    typename C::const_iterator it = starts[task];
+                    for(size_t i = 0; (i < linesPerTask) && (it != records.end()); ++i, ++it)
+                    {
+                        serializer.write(writer, *it);
+                        writer.put('\n');
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                ready[task] = 1;
+                size_t next = written;
+                for(; (next < starts.size()) && ready[next]; ++next)
+                {
+                    os.write(outputs[next].data(), outputs[next].size());
+                    std::string().swap(outputs[next]);
+                }
+                if(next != written)
+                {
+                    written = next;
+                    advanced.notify_all();
+                }
+            }
+            catch(...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    failed = true;
+                }
+                advanced.notify_all();
+                throw;
+            }
+        });
+        workers.join();
+    }
+    template<typename C>
+    inline void writeLines(std::string& output, const C& records, size_t threads = 0)
+    {
+        Seza::StringWriter writer(output);
+        writeLines(writer, records, threads);
+    }
+}
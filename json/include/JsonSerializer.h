@@ -28,10 +28,15 @@
  
 #pragma once;
 
+#include <string.h>
+
+#include <algorithm>
 #include <iomanip>
 
 #include "Seza.h"
+#include "SezaFormat.h"
 #include "JsonDefinitions.h"
+#include "JsonStrings.h"
 
 class JsonSerializer : public Seza::SerializerImpl<JsonSerializer>
 {
@@ -53,11 +58,76 @@ protected:
         os << std::boolalpha << std::setprecision(20) << value;
     }
 
+    void writeValue(Seza::Writer& os, const bool& value) 
+    { 
+        if(value)
+            os.write("true", 4);
+        else
+            os.write("false", 5);
+    }
+    void writeValue(Seza::Writer& os, const char& value) { os.put(value); }
+    void writeValue(Seza::Writer& os, const unsigned char& value) { os.put((char)value); }
+    template<typename Stream> void writeValue(Stream& os, const short& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const unsigned short& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const int& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const unsigned int& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const long& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const unsigned long& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const long long& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const unsigned long long& value) { writeInteger(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const float& value) { writeFloat(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const double& value) { writeFloat(os, value); }
+    template<typename Stream> void writeValue(Stream& os, const long double& value) { writeFloat(os, value); }
+
+    // Integers
+    template<typename Type>
+    void writeInteger(Seza::Writer& os, const Type& value)
+    {
+        size_t length = Seza::formattedLength(value);
+        Seza::formatInteger(os.reserve(length), value);
+        os.commit(length);
+    }
+
+    template<typename Type>
+    void writeInteger(std::wostream& os, const Type& value)
+    {
+        char buffer[24];
+        wchar_t wbuffer[24];
+        size_t length = Seza::formatInteger(buffer, value) - buffer;
+        std::copy(buffer, buffer + length, wbuffer);
+        os.write(wbuffer, length);
+    }
+
+    // Floating point numbers
+    template<typename Type>
+    void writeFloat(Seza::Writer& os, const Type& value)
+    {
+        char buffer[Seza::maxFloatLength];
+        os.write(buffer, Seza::formatFloat(buffer, value) - buffer);
+    }
+
+    template<typename Type>
+    void writeFloat(std::wostream& os, const Type& value)
+    {
+        char buffer[Seza::maxFloatLength];
+        wchar_t wbuffer[Seza::maxFloatLength];
+        size_t length = Seza::formatFloat(buffer, value) - buffer;
+        std::copy(buffer, buffer + length, wbuffer);
+        os.write(wbuffer, length);
+    }
+
     // Strings
     template<typename Stream, typename Type> 
     void writeString(Stream& os, const Type& value)
     {
-        os << JSON::quotationMark <<value.c_str() << JSON::quotationMark;
+        JSON::writeEscaped(os, value.data(), value.size());
+    }
+
+    // Member names
+    template<typename Stream>
+    void writeName(Stream& os, const char* name)
+    {
+        os << JSON::quotationMark << name << JSON::quotationMark;
     }
 
     // Arrays
@@ -78,8 +148,8 @@ protected:
     }
 
     // STL conatiners
-    template<typename Stream>
-    void writeSTLContainer(Stream& os, const Seza::SerializableSTLContainer& container)
+    template<typename Stream, typename Container>
+    void writeSTLContainer(Stream& os, const Container& container)
     {
         os << JSON::beginArray;
 
@@ -95,18 +165,18 @@ protected:
     }
 
     // Serializable class
-    template<typename Stream>
-    void writeSerializable(Stream& os, const Seza::Serializable& object)
+    template<typename Stream, typename Object>
+    void writeSerializable(Stream& os, const Object& object)
     {
         os << JSON::beginObject;
-        writeString(os, std::string("_className_"));
+        writeName(os, "_className_");
         os << JSON::valueSeparator;
-        writeString(os, std::string(object.getClassName()));
+        JSON::writeEscaped(os, object.getClassName(), strlen(object.getClassName()));
 
         for(object.begin(); !object.isEnd(); object.next())
         {
             os << JSON::elementSeparator;
-            object.serializeElemName(this, os);
+            writeName(os, object.getElemName());
             os << JSON::valueSeparator;
             object.serializeElemValue(this, os);
         }
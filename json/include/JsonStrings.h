@@ -0,0 +1,465 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+#include <string.h>
+
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "SezaWriter.h"
+#include "JsonDefinitions.h"
+
+// JSON strings
+namespace JSON
+{
+    /* -- SCANNING -- */
+
+    /** Returns true if c is a quotation mark, a reverse solidus or a control character. These are 
+    the characters that end a plain run inside a JSON string **/
+    template<typename Char>
+    inline bool isSpecial(Char c)
+    {
+        return (c == quotationMark) || (c == '\\') || ((c >= 0) && (c < 0x20));
+    }
+
+    template<>
+    inline bool isSpecial(char c)
+    {
+        return (c == quotationMark) || (c == '\\') || ((unsigned char)c < 0x20);
+    }
+
+    /** Returns the first special character in [begin, end), or end if there is none **/
+    template<typename Char>
+    inline const Char* findSpecial(const Char* begin, const Char* end)
+    {
+        while((begin != end) && !isSpecial(*begin))
+            ++begin;
+        return begin;
+    }
+
+    /** Narrow strings are scanned 32 or 16 bytes at a time **/
+    template<>
+    inline const char* findSpecial(const char* begin, const char* end)
+    {
+#if defined(__AVX2__)
+        const __m256i quote = _mm256_set1_epi8(quotationMark);
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control = _mm256_set1_epi8(0x1F);
+
+        for(; end - begin >= 32; begin += 32)
+        {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)begin);
+            __m256i special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+                _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control)); // chunk <= 0x1F
+
+            unsigned int mask = (unsigned int)_mm256_movemask_epi8(special);
+            if(mask != 0)
+                return begin + __builtin_ctz(mask);
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128i quote = _mm_set1_epi8(quotationMark);
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1F);
+
+        for(; end - begin >= 16; begin += 16)
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)begin);
+            __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control)); // chunk <= 0x1F
+
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(special);
+            if(mask != 0)
+            {
+#if defined(__GNUC__)
+                return begin + __builtin_ctz(mask);
+#else
+                unsigned long index;
+                _BitScanForward(&index, mask);
+                return begin + index;
+#endif
+            }
+        }
+#endif
+        while((begin != end) && !isSpecial(*begin))
+            ++begin;
+        return begin;
+    }
+
+    /* -- UNESCAPING -- */
+
+    inline int hexValue(int c)
+    {
+        if((c >= '0') && (c <= '9'))
+            return c - '0';
+        if((c >= 'a') && (c <= 'f'))
+            return c - 'a' + 10;
+        if((c >= 'A') && (c <= 'F'))
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    /** Reads the 4 hexadecimal digits of a \u escape. Returns -1 if they are not valid **/
+    template<typename Char>
+    inline long readHex4(const Char* p, const Char* end)
+    {
+        if(end - p < 4)
+            return -1;
+
+        long value = 0;
+        for(int i = 0; i < 4; ++i)
+        {
+            int digit = ((p[i] >= 0) && (p[i] < 0x80)) ? hexValue((int)p[i]) : -1;
+            if(digit < 0)
+                return -1;
+            value = (value << 4) | digit;
+        }
+        return value;
+    }
+
+    /** Writes a code point as UTF-8. Returns the end of the output **/
+    inline char* encodeCodePoint(char* out, uint32_t codePoint)
+    {
+        if(codePoint < 0x80)
+            *out++ = (char)codePoint;
+        else if(codePoint < 0x800)
+        {
+            *out++ = (char)(0xC0 | (codePoint >> 6));
+            *out++ = (char)(0x80 | (codePoint & 0x3F));
+        }
+        else if(codePoint < 0x10000)
+        {
+            *out++ = (char)(0xE0 | (codePoint >> 12));
+            *out++ = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            *out++ = (char)(0xF0 | (codePoint >> 18));
+            *out++ = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+            *out++ = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (codePoint & 0x3F));
+        }
+        return out;
+    }
+
+    /** Writes a code point as one wide character, or as a surrogate pair if wchar_t has 16 bits **/
+    inline wchar_t* encodeCodePoint(wchar_t* out, uint32_t codePoint)
+    {
+        if((sizeof(wchar_t) == 2) && (codePoint >= 0x10000))
+        {
+            codePoint -= 0x10000;
+            *out++ = (wchar_t)(0xD800 | (codePoint >> 10));
+            *out++ = (wchar_t)(0xDC00 | (codePoint & 0x3FF));
+        }
+        else
+            *out++ = (wchar_t)codePoint;
+        return out;
+    }
+
+    /** Encodes wide characters as UTF-8. Surrogate pairs are combined when wchar_t has 16 bits
+    and invalid code points are replaced by U+FFFD **/
+    inline void encodeUtf8(const wchar_t* str, size_t length, std::string& value)
+    {
+        const wchar_t* end = str + length;
+        value.clear();
+        value.reserve(length);
+
+        for(; str != end; ++str)
+        {
+            uint32_t c = (uint32_t)*str;
+            if((c >= 0xD800) && (c <= 0xDBFF) && (sizeof(wchar_t) == 2) && (str + 1 != end) && 
+                ((uint32_t)str[1] >= 0xDC00) && ((uint32_t)str[1] <= 0xDFFF))
+            {
+                c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)*++str - 0xDC00);
+            }
+            else if(((c >= 0xD800) && (c <= 0xDFFF)) || (c > 0x10FFFF))
+                c = 0xFFFD;
+
+            char encoded[4];
+            value.append(encoded, encodeCodePoint(encoded, c));
+        }
+    }
+
+    /** Decodes UTF-8 text into wide characters. Bytes that are not part of a valid sequence are
+    taken as Latin-1 characters **/
+    inline void decodeUtf8(const char* str, size_t length, std::wstring& value)
+    {
+        const unsigned char* p = (const unsigned char*)str;
+        const unsigned char* end = p + length;
+        value.clear();
+        value.reserve(length);
+
+        while(p != end)
+        {
+            uint32_t c = *p;
+            size_t count = (c >= 0xF0 && c <= 0xF4) ? 3 : (c >= 0xE0) && (c < 0xF0) ? 2 : (c >= 0xC2) && (c < 0xE0) ? 1 : 0;
+            if(count == 0 || (size_t)(end - p) <= count)
+            {
+                value.push_back((wchar_t)c);
+                ++p;
+                continue;
+            }
+
+            uint32_t codePoint = c & (0x3F >> count);
+            size_t i = 1;
+            for(; (i <= count) && ((p[i] & 0xC0) == 0x80); ++i)
+                codePoint = (codePoint << 6) | (p[i] & 0x3F);
+
+            static const uint32_t minimum[] = { 0, 0x80, 0x800, 0x10000 };
+            if((i <= count) || (codePoint < minimum[count]) || (codePoint > 0x10FFFF) || 
+                ((codePoint >= 0xD800) && (codePoint <= 0xDFFF)))
+            {
+                value.push_back((wchar_t)c);
+                ++p;
+                continue;
+            }
+
+            wchar_t decoded[2];
+            value.append(decoded, encodeCodePoint(decoded, codePoint));
+            p += count + 1;
+        }
+    }
+
+    /** Decodes the escape sequence after a reverse solidus at p. Returns the end of the sequence 
+    or null if it is not valid **/
+    template<typename Char>
+    inline const Char* unescapeSequence(const Char* p, const Char* end, Char*& out)
+    {
+        if(p == end)
+            return 0;
+
+        switch(*p++)
+        {
+        case '\"': *out++ = '\"'; return p;
+        case '\\': *out++ = '\\'; return p;
+        case '/': *out++ = '/'; return p;
+        case 'b': *out++ = '\b'; return p;
+        case 'f': *out++ = '\f'; return p;
+        case 'n': *out++ = '\n'; return p;
+        case 'r': *out++ = '\r'; return p;
+        case 't': *out++ = '\t'; return p;
+        case 'u':
+        {
+            long codePoint = readHex4(p, end);
+            if(codePoint < 0)
+                return 0;
+            p += 4;
+
+            if((codePoint >= 0xDC00) && (codePoint <= 0xDFFF)) // Lone low surrogate
+                return 0;
+            if((codePoint >= 0xD800) && (codePoint <= 0xDBFF)) // High surrogate, a low one must follow
+            {
+                if((end - p < 2) || (p[0] != '\\') || (p[1] != 'u'))
+                    return 0;
+                long low = readHex4(p + 2, end);
+                if((low < 0xDC00) || (low > 0xDFFF))
+                    return 0;
+                p += 6;
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+
+            out = encodeCodePoint(out, (uint32_t)codePoint);
+            return p;
+        }
+        default:
+            return 0;
+        }
+    }
+
+    /** Decodes the escape sequences of the string content [str, str + length) in place: the output 
+    is never longer than the input. Plain runs are found with findSpecial and moved in blocks. 
+    Returns the new length, or std::string::npos if the content is not a valid JSON string **/
+    template<typename Char>
+    inline size_t unescape(Char* str, size_t length)
+    {
+        const Char* p = str;
+        const Char* end = str + length;
+        Char* out = str;
+
+        while(true)
+        {
+            const Char* special = findSpecial(p, end);
+            if(out != p)
+                memmove(out, p, (special - p) * sizeof(Char));
+            out += special - p;
+            p = special;
+
+            if(p == end)
+                break;
+            if(*p != '\\') // Unescaped quotation mark or control character
+                return std::string::npos;
+            if((p = unescapeSequence(p + 1, end, out)) == 0)
+                return std::string::npos;
+        }
+
+        return out - str;
+    }
+
+    /** Returns true if the text ends in an odd count of reverse solidus, that is, 
+    if a quotation mark after it would be escaped **/
+    template<typename String>
+    inline bool endsInEscape(const String& text)
+    {
+        size_t count = 0;
+        for(size_t i = text.size(); (i > 0) && (text[i - 1] == '\\'); --i)
+            ++count;
+        return (count % 2) == 1;
+    }
+
+    /* -- ESCAPING -- */
+
+    /** Writes the escape sequence of a special character c. Returns its length, at most 6 **/
+    template<typename Char>
+    inline size_t escapeCharacter(Char* out, unsigned int c)
+    {
+        static const char hexDigits[] = "0123456789abcdef";
+
+        out[0] = '\\';
+        switch(c)
+        {
+        case '\"': out[1] = '\"'; return 2;
+        case '\\': out[1] = '\\'; return 2;
+        case '\b': out[1] = 'b'; return 2;
+        case '\f': out[1] = 'f'; return 2;
+        case '\n': out[1] = 'n'; return 2;
+        case '\r': out[1] = 'r'; return 2;
+        case '\t': out[1] = 't'; return 2;
+        default:
+            out[1] = 'u';
+            out[2] = '0';
+            out[3] = '0';
+            out[4] = hexDigits[(c >> 4) & 0xF];
+            out[5] = hexDigits[c & 0xF];
+            return 6;
+        }
+    }
+
+    /** Writes a quoted JSON string. Plain runs are found with findSpecial and copied in blocks **/
+    inline void writeEscaped(Seza::Writer& os, const char* str, size_t length)
+    {
+        const char* end = str + length;
+        char escape[6];
+
+        os.put(quotationMark);
+        while(true)
+        {
+            const char* special = findSpecial(str, end);
+            os.write(str, special - str);
+            if(special == end)
+                break;
+
+            os.write(escape, escapeCharacter(escape, (unsigned char)*special));
+            str = special + 1;
+        }
+        os.put(quotationMark);
+    }
+
+    /** Writes a quoted JSON string from a wide string, encoded as UTF-8. Surrogate pairs are 
+    combined when wchar_t has 16 bits and invalid code points are replaced by U+FFFD **/
+    inline void writeEscaped(Seza::Writer& os, const wchar_t* str, size_t length)
+    {
+        const wchar_t* end = str + length;
+        char buffer[256];
+        char* const bufferEnd = buffer + sizeof(buffer) - 6;
+
+        os.put(quotationMark);
+        while(str != end)
+        {
+            char* out = buffer;
+            for(; (str != end) && (out <= bufferEnd); ++str)
+            {
+                uint32_t c = (uint32_t)*str;
+                if(c < 0x80)
+                {
+                    if(isSpecial((char)c))
+                        out += escapeCharacter(out, c);
+                    else
+                        *out++ = (char)c;
+                    continue;
+                }
+
+                if((c >= 0xD800) && (c <= 0xDBFF) && (sizeof(wchar_t) == 2) && (str + 1 != end) && 
+                    ((uint32_t)str[1] >= 0xDC00) && ((uint32_t)str[1] <= 0xDFFF))
+                {
+                    c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)*++str - 0xDC00);
+                }
+                else if(((c >= 0xD800) && (c <= 0xDFFF)) || (c > 0x10FFFF))
+                    c = 0xFFFD;
+
+                out = encodeCodePoint(out, c);
+            }
+            os.write(buffer, out - buffer);
+        }
+        os.put(quotationMark);
+    }
+
+    /** Writes a quoted JSON string to a wide stream **/
+    template<typename Char>
+    inline void writeEscaped(std::wostream& os, const Char* str, size_t length)
+    {
+        const Char* end = str + length;
+        wchar_t buffer[256];
+        size_t used = 0;
+
+        os.put(quotationMark);
+        while(true)
+        {
+            const Char* special = findSpecial(str, end);
+            for(; str != special; ++str)
+            {
+                if(used == sizeof(buffer) / sizeof(wchar_t))
+                {
+                    os.write(buffer, used);
+                    used = 0;
+                }
+                buffer[used++] = (wchar_t)*str;
+            }
+            os.write(buffer, used);
+            used = 0;
+            if(special == end)
+                break;
+
+            wchar_t escape[6];
+            os.write(escape, escapeCharacter(escape, (unsigned int)(typename std::make_unsigned<Char>::type)*special));
+            str = special + 1;
+        }
+        os.put(quotationMark);
+    }
+}
@@ -0,0 +1,332 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+#include "SezaReader.h"
+#include "JsonDefinitions.h"
+
+// JSON structural index
+namespace JSON
+{
+    /* -- STAGE 1: CLASSIFICATION -- */
+
+    namespace Structural
+    {
+        /** Masks of a block of 64 bytes, with one bit per byte **/
+        struct Block
+        {
+            uint64_t quote;
+            uint64_t backslash;
+            uint64_t operators; // { } [ ] : ,
+            uint64_t whitespace;
+        };
+
+        static const size_t blockSize = 64;
+
+#if defined(__AVX2__)
+        inline uint64_t compare(const __m256i& low, const __m256i& high, char c)
+        {
+            const __m256i value = _mm256_set1_epi8(c);
+            return (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, value)) | 
+                ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, value)) << 32);
+        }
+
+        inline void classify(const char* p, Block& block)
+        {
+            const __m256i low = _mm256_loadu_si256((const __m256i*)p);
+            const __m256i high = _mm256_loadu_si256((const __m256i*)(p + 32));
+            const __m256i caseBit = _mm256_set1_epi8(0x20); // Maps [ and ] to { and }
+            const __m256i lowerLow = _mm256_or_si256(low, caseBit);
+            const __m256i lowerHigh = _mm256_or_si256(high, caseBit);
+
+            block.quote = compare(low, high, quotationMark);
+            block.backslash = compare(low, high, '\\');
+            block.operators = compare(lowerLow, lowerHigh, beginObject) | compare(lowerLow, lowerHigh, endObject) |
+                compare(low, high, valueSeparator) | compare(low, high, elementSeparator);
+            block.whitespace = compare(low, high, ' ') | compare(low, high, '\t') | compare(low, high, '\n') | compare(low, high, '\r');
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        inline uint64_t compare(const __m128i* chunks, char c)
+        {
+            const __m128i value = _mm_set1_epi8(c);
+            uint64_t mask = 0;
+            for(int i = 0; i < 4; ++i)
+                mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], value)) << (16 * i);
+            return mask;
+        }
+
+        inline void classify(const char* p, Block& block)
+        {
+            __m128i chunks[4];
+            __m128i lower[4];
+            for(int i = 0; i < 4; ++i)
+            {
+                chunks[i] = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+                lower[i] = _mm_or_si128(chunks[i], _mm_set1_epi8(0x20)); // Maps [ and ] to { and }
+            }
+
+            block.quote = compare(chunks, quotationMark);
+            block.backslash = compare(chunks, '\\');
+            block.operators = compare(lower, beginObject) | compare(lower, endObject) | 
+                compare(chunks, valueSeparator) | compare(chunks, elementSeparator);
+            block.whitespace = compare(chunks, ' ') | compare(chunks, '\t') | compare(chunks, '\n') | compare(chunks, '\r');
+        }
+#else
+        inline void classify(const char* p, Block& block)
+        {
+            block.quote = block.backslash = block.operators = block.whitespace = 0;
+            for(size_t i = 0; i < blockSize; ++i)
+            {
+                uint64_t bit = (uint64_t)1 << i;
+                switch(p[i])
+                {
+                case quotationMark: block.quote |= bit; break;
+                case '\\': block.backslash |= bit; break;
+                case beginObject: case endObject: case beginArray: case endArray:
+                case valueSeparator: case elementSeparator: block.operators |= bit; break;
+                case ' ': case '\t': case '\n': case '\r': block.whitespace |= bit; break;
+                }
+            }
+        }
+#endif
+
+        /** Sets each bit to the xor of itself and all the lower ones **/
+        inline uint64_t prefixXor(uint64_t bits)
+        {
+#if defined(__PCLMUL__)
+            return (uint64_t)_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, (long long)bits), _mm_set1_epi8(-1), 0));
+#else
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+#endif
+        }
+
+        /** Returns the bytes that follow an odd sequence of backslashes. carry keeps whether 
+        the previous block ended in an odd sequence **/
+        inline uint64_t escaped(uint64_t backslash, uint64_t& carry)
+        {
+            const uint64_t evenBits = 0x5555555555555555ULL;
+            const uint64_t oddBits = ~evenBits;
+
+            uint64_t startEdges = backslash & ~(backslash << 1);
+            uint64_t evenStartMask = evenBits ^ carry;
+            uint64_t evenStarts = startEdges & evenStartMask;
+            uint64_t oddStarts = startEdges & ~evenStartMask;
+            uint64_t evenCarries = backslash + evenStarts;
+            uint64_t oddCarries = backslash + oddStarts;
+            bool endsOdd = oddCarries < backslash;
+
+            oddCarries |= carry;
+            carry = endsOdd ? 1 : 0;
+
+            uint64_t evenCarryEnds = evenCarries & ~backslash;
+            uint64_t oddCarryEnds = oddCarries & ~backslash;
+            return (evenCarryEnds & oddBits) | (oddCarryEnds & evenBits);
+        }
+    }
+
+    /** Positions of the significant bytes of a JSON text: structural characters, opening quotation 
+    marks and the first byte of each number or literal. Whitespace and string contents are left out **/
+    class StructuralIndex
+    {
+    public:
+        /** Builds the index of [data, data + size). Returns false if a string is not terminated 
+        or the text does not fit in 32 bits offsets **/
+        bool build(const char* data, size_t size)
+        {
+            _positions.clear();
+            if(size > 0xFFFFFFFFu)
+                return false;
+
+            uint64_t escapeCarry = 0;
+            uint64_t inStringCarry = 0;
+            uint64_t scalarCarry = 0;
+            size_t count = 0;
+            char tail[Structural::blockSize];
+
+            for(size_t offset = 0; offset < size; offset += Structural::blockSize)
+            {
+                const char* p = data + offset;
+                if(size - offset < Structural::blockSize) // Last block padded with whitespace
+                {
+                    memset(tail, ' ', sizeof(tail));
+                    memcpy(tail, p, size - offset);
+                    p = tail;
+                }
+
+                Structural::Block block;
+                Structural::classify(p, block);
+
+                uint64_t quote = block.quote & ~Structural::escaped(block.backslash, escapeCarry);
+                uint64_t inString = Structural::prefixXor(quote) ^ inStringCarry; // Opening quotes included
+                inStringCarry = (uint64_t)((int64_t)inString >> 63);
+
+                uint64_t scalar = ~(block.operators | block.whitespace | quote | inString);
+                uint64_t scalarStart = scalar & ~((scalar << 1) | scalarCarry);
+                scalarCarry = scalar >> 63;
+
+                uint64_t marks = ((block.operators | scalarStart) & ~inString) | (quote & inString);
+
+                if(_positions.size() < count + Structural::blockSize)
+                    _positions.resize(2 * _positions.size() + Structural::blockSize);
+                for(; marks != 0; marks &= marks - 1)
+                    _positions[count++] = (uint32_t)(offset + trailingZeros(marks));
+            }
+
+            _positions.resize(count);
+            return inStringCarry == 0;
+        }
+
+        /** Counts the elements of the arrays of data, the text the index was built from. Arrays 
+        not terminated are given no elements **/
+        void countArrays(const char* data)
+        {
+            static const size_t object = (size_t)-1;
+            std::vector<std::pair<size_t, uint32_t> > open; // Entry in _counts and elements of the open arrays
+            _counts.clear();
+            for(size_t mark = 0; mark < _positions.size(); ++mark)
+            {
+                switch(data[_positions[mark]])
+                {
+                case JSON::beginArray:
+                    {
+                        bool empty = (mark + 1 < _positions.size()) && (data[_positions[mark + 1]] == JSON::endArray);
+                        Seza::Reader::Count count = { _positions[mark], 0 };
+                        open.push_back(std::make_pair(_counts.size(), empty ? 0u : 1u));
+                        _counts.push_back(count);
+                    }
+                    break;
+                case JSON::beginObject:
+                    open.push_back(std::make_pair(object, 0u));
+                    break;
+                case JSON::elementSeparator:
+                    if(!open.empty())
+                        ++open.back().second;
+                    break;
+                case JSON::endArray:
+                case JSON::endObject:
+                    if(open.empty())
+                        break;
+                    if(open.back().first != object)
+                        _counts[open.back().first].count = open.back().second;
+                    open.pop_back();
+                    break;
+                }
+            }
+        }
+
+        size_t size() const { return _positions.size(); }
+        const uint32_t* begin() const { return _positions.empty() ? 0 : &_positions[0]; }
+        const uint32_t* end() const { return begin() + size(); }
+        uint32_t operator[](size_t i) const { return _positions[i]; }
+        const Seza::Reader::Count* countsBegin() const { return _counts.empty() ? 0 : &_counts[0]; }
+        const Seza::Reader::Count* countsEnd() const { return countsBegin() + _counts.size(); }
+
+    private:
+        static int trailingZeros(uint64_t bits)
+        {
+#if defined(__GNUC__)
+            return __builtin_ctzll(bits);
+#else
+            int count = 0;
+            while((bits & 1) == 0)
+            {
+                bits >>= 1;
+                ++count;
+            }
+            return count;
+#endif
+        }
+
+        std::vector<uint32_t> _positions;
+        std::vector<Seza::Reader::Count> _counts;
+    };
+
+    /* -- STAGE 2: INDEXED READING -- */
+
+    /** Reader over a buffer with its structural index. The deserializer jumps from one significant 
+    byte to the next one instead of skipping whitespace. If the index cannot be built, it is read 
+    as a plain buffer **/
+    class IndexedReader : public Seza::BufferReader
+    {
+    public:
+        IndexedReader(const char* data, size_t size) :
+            Seza::BufferReader(data, size)
+        {
+            buildIndex();
+        }
+        IndexedReader(const std::string& data) :
+            Seza::BufferReader(data)
+        {
+            buildIndex();
+        }
+
+        const StructuralIndex& index() const { return _index; }
+
+    private:
+        IndexedReader(const IndexedReader&);
+        IndexedReader& operator=(const IndexedReader&);
+
+        void buildIndex()
+        {
+            if(_index.build(_begin, (size_t)(_end - _begin)) && (_index.size() > 0))
+            {
+                _base = _begin;
+                _mark = _index.begin();
+                _marksEnd = _index.end();
+                _index.countArrays(_begin);
+                _count = _index.countsBegin();
+                _countsEnd = _index.countsEnd();
+            }
+        }
+
+        StructuralIndex _index;
+    };
+}
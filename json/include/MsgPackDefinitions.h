@@ -0,0 +1,199 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+
+#include <exception>
+
+#include "SezaReader.h"
+#include "SezaWriter.h"
+
+// MessagePack Definitions
+namespace MsgPack
+{
+    /** This exception is thrown when the input is not valid, or when a wide stream is used **/
+    class MsgPackException : public std::exception
+    {
+    public:
+      const char* what() const throw() { return "Invalid MessagePack format!\n"; }
+    };
+
+    /* -- FORMATS -- */
+
+    static const unsigned char positiveFixInt = 0x00;
+    static const unsigned char fixMap = 0x80;
+    static const unsigned char fixArray = 0x90;
+    static const unsigned char fixStr = 0xa0;
+    static const unsigned char nil = 0xc0;
+    static const unsigned char falseValue = 0xc2;
+    static const unsigned char trueValue = 0xc3;
+    static const unsigned char float32 = 0xca;
+    static const unsigned char float64 = 0xcb;
+    static const unsigned char uint8 = 0xcc;
+    static const unsigned char uint16 = 0xcd;
+    static const unsigned char uint32 = 0xce;
+    static const unsigned char uint64 = 0xcf;
+    static const unsigned char int8 = 0xd0;
+    static const unsigned char int16 = 0xd1;
+    static const unsigned char int32 = 0xd2;
+    static const unsigned char int64 = 0xd3;
+    static const unsigned char str8 = 0xd9;
+    static const unsigned char str16 = 0xda;
+    static const unsigned char str32 = 0xdb;
+    static const unsigned char array16 = 0xdc;
+    static const unsigned char array32 = 0xdd;
+    static const unsigned char map16 = 0xde;
+    static const unsigned char map32 = 0xdf;
+    static const unsigned char negativeFixInt = 0xe0;
+
+    /* -- WRITING -- */
+
+    /** Writes the format byte followed by value in big endian order **/
+    template<typename Unsigned>
+    inline void writeBigEndian(Seza::Writer& os, unsigned char format, Unsigned value)
+    {
+        char* out = os.reserve(1 + sizeof(Unsigned));
+        out[0] = (char)format;
+        for(size_t i = sizeof(Unsigned); i > 0; --i)
+        {
+            out[i] = (char)(value & 0xFF);
+            value = (Unsigned)(value >> 4 >> 4); // Also valid for one byte types
+        }
+        os.commit(1 + sizeof(Unsigned));
+    }
+
+    /** Writes an unsigned integer with the smallest format **/
+    inline void writeUnsigned(Seza::Writer& os, uint64_t value)
+    {
+        if(value < 0x80)
+            os.put((char)value);
+        else if(value <= 0xFF)
+            writeBigEndian(os, uint8, (uint8_t)value);
+        else if(value <= 0xFFFF)
+            writeBigEndian(os, uint16, (uint16_t)value);
+        else if(value <= 0xFFFFFFFF)
+            writeBigEndian(os, uint32, (uint32_t)value);
+        else
+            writeBigEndian(os, uint64, value);
+    }
+
+    /** Writes a signed integer with the smallest format. Positive values use the unsigned ones **/
+    inline void writeSigned(Seza::Writer& os, int64_t value)
+    {
+        if(value >= 0)
+            writeUnsigned(os, (uint64_t)value);
+        else if(value >= -32)
+            os.put((char)value);
+        else if(value >= INT8_MIN)
+            writeBigEndian(os, int8, (uint8_t)value);
+        else if(value >= INT16_MIN)
+            writeBigEndian(os, int16, (uint16_t)value);
+        else if(value >= INT32_MIN)
+            writeBigEndian(os, int32, (uint32_t)value);
+        else
+            writeBigEndian(os, int64, (uint64_t)value);
+    }
+
+    /** Writes the header of a string, an array or a map with the smallest format **/
+    inline void writeHeader(Seza::Writer& os, unsigned char fixFormat, size_t fixSize, unsigned char format16, size_t size)
+    {
+        if(size < fixSize)
+            os.put((char)(fixFormat | size));
+        else if(size <= 0xFFFF)
+            writeBigEndian(os, format16, (uint16_t)size);
+        else if((uint64_t)size <= 0xFFFFFFFF)
+            writeBigEndian(os, (unsigned char)(format16 + 1), (uint32_t)size);
+        else
+            throw new MsgPackException();
+    }
+
+    inline void writeStringHeader(Seza::Writer& os, size_t size)
+    {
+        if((size >= 32) && (size <= 0xFF))
+            writeBigEndian(os, str8, (uint8_t)size);
+        else
+            writeHeader(os, fixStr, 32, str16, size);
+    }
+    inline void writeArrayHeader(Seza::Writer& os, size_t size) { writeHeader(os, fixArray, 16, array16, size); }
+    inline void writeMapHeader(Seza::Writer& os, size_t size) { writeHeader(os, fixMap, 16, map16, size); }
+
+    /* -- READING -- */
+
+    /** Reads a big endian value of sizeof(Unsigned) bytes **/
+    template<typename Unsigned>
+    inline Unsigned readBigEndian(Seza::Reader& is)
+    {
+        if(!is.require(sizeof(Unsigned)))
+            throw new MsgPackException();
+
+        const unsigned char* in = (const unsigned char*)is.cursor();
+        Unsigned value = 0;
+        for(size_t i = 0; i < sizeof(Unsigned); ++i)
+            value = (Unsigned)((value << 4 << 4) | in[i]);
+        is.skip(sizeof(Unsigned));
+        return value;
+    }
+
+    /** Reads the format byte **/
+    inline int readFormat(Seza::Reader& is)
+    {
+        int c = is.get();
+        if(c == Seza::Reader::eof)
+            throw new MsgPackException();
+        return c;
+    }
+
+    inline bool isMapHeader(int c) { return ((c & 0xF0) == fixMap) || (c == map16) || (c == map32); }
+
+    /** Reads the header of a string, an array or a map. Returns its size **/
+    inline size_t readHeader(Seza::Reader& is, unsigned char fixFormat, unsigned char fixMask, unsigned char format16)
+    {
+        int c = readFormat(is);
+        if((c & ~fixMask) == fixFormat)
+            return (size_t)(c & fixMask);
+        if(c == format16)
+            return readBigEndian<uint16_t>(is);
+        if(c == format16 + 1)
+            return readBigEndian<uint32_t>(is);
+        throw new MsgPackException();
+    }
+
+    inline size_t readStringHeader(Seza::Reader& is)
+    {
+        if(is.peek() == str8)
+        {
+            is.skip(1);
+            return readBigEndian<uint8_t>(is);
+        }
+        return readHeader(is, fixStr, 0x1F, str16);
+    }
+    inline size_t readArrayHeader(Seza::Reader& is) { return readHeader(is, fixArray, 0x0F, array16); }
+    inline size_t readMapHeader(Seza::Reader& is) { return readHeader(is, fixMap, 0x0F, map16); }
+}
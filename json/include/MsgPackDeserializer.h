@@ -0,0 +1,300 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "Seza.h"
+#include "MsgPackDefinitions.h"
+#include "JsonStrings.h"
+
+/** Reads the MessagePack format written by MsgPackSerializer. Numbers are accepted in any
+format that fits the destination type, and maps are also accepted as arrays of pairs **/
+class MsgPackDeserializer : public Seza::DeserializerImpl<MsgPackDeserializer>
+{
+public:
+    MsgPackDeserializer() : _entry(false) {}
+
+protected:
+    friend class Seza::DeserializerImpl<MsgPackDeserializer>;
+
+    // null
+    void readNull(Seza::Reader& is)
+    {
+        if(MsgPack::readFormat(is) != MsgPack::nil)
+            throw new MsgPack::MsgPackException();
+    }
+
+    // Values
+    void readValue(Seza::Reader& is, bool& value) 
+    { 
+        int c = MsgPack::readFormat(is);
+        if((c != MsgPack::trueValue) && (c != MsgPack::falseValue))
+            throw new MsgPack::MsgPackException();
+        value = (c == MsgPack::trueValue);
+    }
+    void readValue(Seza::Reader& is, char& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, unsigned char& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, short& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, unsigned short& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, int& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, unsigned int& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, long& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, unsigned long& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, long long& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, unsigned long long& value) { readInteger(is, value); }
+    void readValue(Seza::Reader& is, float& value) { readFloat(is, value); }
+    void readValue(Seza::Reader& is, double& value) { readFloat(is, value); }
+    void readValue(Seza::Reader& is, long double& value) { readFloat(is, value); }
+
+    // Numbers
+    enum NumberType { unsignedNumber, signedNumber, float32Number, float64Number };
+
+    /** Reads a number of any format. Returns its type, the bits are left in value **/
+    NumberType readNumber(Seza::Reader& is, uint64_t& value)
+    {
+        int c = MsgPack::readFormat(is);
+        if(c < 0x80)
+        {
+            value = (uint64_t)c;
+            return unsignedNumber;
+        }
+        if(c >= MsgPack::negativeFixInt)
+        {
+            value = (uint64_t)(int64_t)(int8_t)c;
+            return signedNumber;
+        }
+
+        switch(c)
+        {
+        case MsgPack::uint8: value = MsgPack::readBigEndian<uint8_t>(is); return unsignedNumber;
+        case MsgPack::uint16: value = MsgPack::readBigEndian<uint16_t>(is); return unsignedNumber;
+        case MsgPack::uint32: value = MsgPack::readBigEndian<uint32_t>(is); return unsignedNumber;
+        case MsgPack::uint64: value = MsgPack::readBigEndian<uint64_t>(is); return unsignedNumber;
+        case MsgPack::int8: value = (uint64_t)(int64_t)(int8_t)MsgPack::readBigEndian<uint8_t>(is); return signedNumber;
+        case MsgPack::int16: value = (uint64_t)(int64_t)(int16_t)MsgPack::readBigEndian<uint16_t>(is); return signedNumber;
+        case MsgPack::int32: value = (uint64_t)(int64_t)(int32_t)MsgPack::readBigEndian<uint32_t>(is); return signedNumber;
+        case MsgPack::int64: value = MsgPack::readBigEndian<uint64_t>(is); return signedNumber;
+        case MsgPack::float32: value = MsgPack::readBigEndian<uint32_t>(is); return float32Number;
+        case MsgPack::float64: value = MsgPack::readBigEndian<uint64_t>(is); return float64Number;
+        default: throw new MsgPack::MsgPackException();
+        }
+    }
+
+    /** Integers must fit the destination type **/
+    template<typename Int>
+    void readInteger(Seza::Reader& is, Int& value)
+    {
+        uint64_t bits;
+        NumberType type = readNumber(is, bits);
+        if((type == signedNumber) && ((int64_t)bits < 0))
+        {
+            if(!std::numeric_limits<Int>::is_signed || ((int64_t)bits < (int64_t)std::numeric_limits<Int>::min()))
+                throw new MsgPack::MsgPackException();
+        }
+        else if((type != unsignedNumber) && (type != signedNumber))
+            throw new MsgPack::MsgPackException();
+        else if(bits > (uint64_t)std::numeric_limits<Int>::max())
+            throw new MsgPack::MsgPackException();
+
+        value = (Int)(int64_t)bits;
+    }
+
+    template<typename Float>
+    void readFloat(Seza::Reader& is, Float& value)
+    {
+        uint64_t bits;
+        switch(readNumber(is, bits))
+        {
+        case unsignedNumber: value = (Float)bits; break;
+        case signedNumber: value = (Float)(int64_t)bits; break;
+        case float32Number: 
+            {
+                uint32_t bits32 = (uint32_t)bits;
+                float number;
+                memcpy(&number, &bits32, sizeof(number));
+                value = (Float)number;
+                break;
+            }
+        case float64Number: 
+            {
+                double number;
+                memcpy(&number, &bits, sizeof(number));
+                value = (Float)number;
+                break;
+            }
+        }
+    }
+
+    // String
+    template<typename A>
+    void readString(Seza::Reader& is, std::basic_string<char, std::char_traits<char>, A>& value)
+    {
+        value.clear();
+        readBytes(is, value, MsgPack::readStringHeader(is));
+    }
+
+    void readString(Seza::Reader& is, std::wstring& value)
+    {
+        std::string tmp;
+        readString(is, tmp);
+        JSON::decodeUtf8(tmp.data(), tmp.size(), value);
+    }
+
+    // Member names
+    /** Names are looked up straight from the input buffer when they are whole in it **/
+    const Seza::MemberDescriptor* readName(Seza::Reader& is, const Seza::MemberTable& members)
+    {
+        size_t size = MsgPack::readStringHeader(is);
+        if(is.fill() && (is.available() >= size))
+        {
+            const Seza::MemberDescriptor* member = members.find(is.cursor(), size);
+            is.skip(size);
+            return member;
+        }
+
+        _name.clear();
+        readBytes(is, _name, size);
+        return members.find(_name.data(), size);
+    }
+
+    // Arrays
+    template<typename T> 
+    size_t readArray(Seza::Reader& is, T* vector, const size_t& size)
+    {
+        size_t length = MsgPack::readArrayHeader(is);
+        if(length > size)
+            throw new MsgPack::MsgPackException();
+
+        for(size_t i = 0; i < length; ++i)
+            this->read(is, vector[i]);
+
+        return length;
+    }
+    
+    // STL containers
+    /** The entries of a map are read as the pairs of the container, without an array header **/
+    template<typename Container>
+    void readSTLContainer(Seza::Reader& is, Container& container)
+    {
+        this->checkStack();
+        bool entry = _entry;
+        _entry = false;
+
+        if(entry)
+        {
+            container.deserializeElem(this, is);
+            container.deserializeElem(this, is);
+        }
+        else if(container.isMap() && MsgPack::isMapHeader(is.peek()))
+        {
+            // Each entry takes at least one byte, so the count is only trusted up to the bytes available
+            size_t count = MsgPack::readMapHeader(is);
+            container.reserve(std::min(count, is.available()));
+            for(; count > 0; --count)
+            {
+                _entry = true;
+                container.deserializeElem(this, is);
+            }
+        }
+        else
+        {
+            size_t count = MsgPack::readArrayHeader(is);
+            container.reserve(std::min(count, is.available()));
+            for(; count > 0; --count)
+                container.deserializeElem(this, is);
+        }
+    }
+
+    // Serializable class
+    /** The _className_ entry is optional, so maps written by other components can be read **/
+    template<typename Object>
+    void readSerializable(Seza::Reader& is, const Object& object)
+    {
+        this->checkStack();
+        size_t count = MsgPack::readMapHeader(is);
+
+        static const char classNameKey[] = "\xAB_className_";
+        if((count > 0) && is.require(sizeof(classNameKey) - 1) && 
+            (memcmp(is.cursor(), classNameKey, sizeof(classNameKey) - 1) == 0))
+        {
+            is.skip(sizeof(classNameKey) - 1);
+            size_t size = MsgPack::readStringHeader(is);
+            if((size != strlen(object.getClassName())) || !is.require(size) || 
+                (memcmp(is.cursor(), object.getClassName(), size) != 0))
+            {
+                throw new MsgPack::MsgPackException();
+            }
+            is.skip(size);
+            --count;
+        }
+
+        for(; count > 0; --count)
+        {
+            if(!object.deserializeElemName(this, is))
+                throw new MsgPack::MsgPackException();
+
+            object.deserializeElemValue(this, is);
+        }
+    }
+
+    // Wide streams
+    void readNull(std::wistream& is) { throw new MsgPack::MsgPackException(); }
+    template<typename T> void readValue(std::wistream& is, T& value) { throw new MsgPack::MsgPackException(); }
+    template<typename T> void readString(std::wistream& is, T& value) { throw new MsgPack::MsgPackException(); }
+    const Seza::MemberDescriptor* readName(std::wistream& is, const Seza::MemberTable& members) { throw new MsgPack::MsgPackException(); }
+    template<typename T> size_t readArray(std::wistream& is, T* vector, const size_t& size) { throw new MsgPack::MsgPackException(); }
+    template<typename Container> void readSTLContainer(std::wistream& is, Container& container) { throw new MsgPack::MsgPackException(); }
+    template<typename Object> void readSerializable(std::wistream& is, const Object& object) { throw new MsgPack::MsgPackException(); }
+
+    /** Appends size bytes from the reader to a string. The size is not trusted, the string grows a 
+    buffer at a time as the bytes are read **/
+    template<typename String>
+    static void readBytes(Seza::Reader& is, String& value, size_t size)
+    {
+        while(size > 0)
+        {
+            if(!is.fill())
+                throw new MsgPack::MsgPackException();
+
+            size_t length = std::min(is.available(), size);
+            value.append(is.cursor(), length);
+            is.skip(length);
+            size -= length;
+        }
+    }
+
+    /** Set while reading the entries of a map **/
+    bool _entry;
+    /** Names split across buffers **/
+    std::string _name;
+};
@@ -0,0 +1,176 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include "Seza.h"
+#include "MsgPackDefinitions.h"
+#include "JsonStrings.h"
+
+/** MessagePack format. Integers and strings use their smallest encoding, Serializable objects
+are written as maps from member names to values, after a _className_ entry like the JSON format, 
+and STL containers as arrays, or as maps if their elements are key-value pairs **/
+class MsgPackSerializer : public Seza::SerializerImpl<MsgPackSerializer>
+{
+public:
+    MsgPackSerializer() : _entry(false) {}
+
+protected:
+
+    friend class Seza::SerializerImpl<MsgPackSerializer>;
+
+    // null
+    void writeNull(Seza::Writer& os)
+    {
+        os.put((char)MsgPack::nil);
+    }
+
+    // Values
+    void writeValue(Seza::Writer& os, const bool& value) { os.put((char)(value ? MsgPack::trueValue : MsgPack::falseValue)); }
+    void writeValue(Seza::Writer& os, const char& value) { MsgPack::writeSigned(os, value); }
+    void writeValue(Seza::Writer& os, const unsigned char& value) { MsgPack::writeUnsigned(os, value); }
+    void writeValue(Seza::Writer& os, const short& value) { MsgPack::writeSigned(os, value); }
+    void writeValue(Seza::Writer& os, const unsigned short& value) { MsgPack::writeUnsigned(os, value); }
+    void writeValue(Seza::Writer& os, const int& value) { MsgPack::writeSigned(os, value); }
+    void writeValue(Seza::Writer& os, const unsigned int& value) { MsgPack::writeUnsigned(os, value); }
+    void writeValue(Seza::Writer& os, const long& value) { MsgPack::writeSigned(os, value); }
+    void writeValue(Seza::Writer& os, const unsigned long& value) { MsgPack::writeUnsigned(os, value); }
+    void writeValue(Seza::Writer& os, const long long& value) { MsgPack::writeSigned(os, value); }
+    void writeValue(Seza::Writer& os, const unsigned long long& value) { MsgPack::writeUnsigned(os, value); }
+
+    void writeValue(Seza::Writer& os, const float& value) 
+    { 
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        MsgPack::writeBigEndian(os, MsgPack::float32, bits);
+    }
+    void writeValue(Seza::Writer& os, const double& value) 
+    { 
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        MsgPack::writeBigEndian(os, MsgPack::float64, bits);
+    }
+    /** MessagePack has no extended precision. Long doubles are written as doubles **/
+    void writeValue(Seza::Writer& os, const long double& value) 
+    { 
+        double number = (double)value;
+        writeValue(os, number);
+    }
+
+    // Strings
+    /** Narrow strings of any allocator and string views **/
+    template<typename Type>
+    void writeString(Seza::Writer& os, const Type& value)
+    {
+        MsgPack::writeStringHeader(os, value.size());
+        os.write(value.data(), value.size());
+    }
+
+    /** Wide strings are encoded as UTF-8 **/
+    void writeString(Seza::Writer& os, const std::wstring& value)
+    {
+        std::string encoded;
+        JSON::encodeUtf8(value.data(), value.size(), encoded);
+        writeString(os, encoded);
+    }
+
+    // Arrays
+    template<typename Type> 
+    void writeArray(Seza::Writer& os, const Type* vector, const size_t& size)
+    {
+        MsgPack::writeArrayHeader(os, size);
+        
+        for(size_t i=0; i<size; ++i)
+            this->write(os, vector[i]);
+    }
+
+    // STL conatiners
+    /** The pairs of a map are written as its entries, without an array header **/
+    template<typename Container>
+    void writeSTLContainer(Seza::Writer& os, const Container& container)
+    {
+        bool entry = _entry;
+        _entry = false;
+
+        if(entry)
+        {
+            for(container.begin(); !container.isEnd(); container.next())
+                container.serializeElem(this, os);
+        }
+        else if(container.isMap())
+        {
+            MsgPack::writeMapHeader(os, container.size());
+            for(container.begin(); !container.isEnd(); container.next())
+            {
+                _entry = true;
+                container.serializeElem(this, os);
+            }
+        }
+        else
+        {
+            MsgPack::writeArrayHeader(os, container.size());
+            for(container.begin(); !container.isEnd(); container.next())
+                container.serializeElem(this, os);
+        }
+    }
+
+    // Serializable class
+    template<typename Object>
+    void writeSerializable(Seza::Writer& os, const Object& object)
+    {
+        MsgPack::writeMapHeader(os, object.membersCount() + 1);
+        writeName(os, "_className_", sizeof("_className_") - 1);
+        writeName(os, object.getClassName(), strlen(object.getClassName()));
+
+        for(object.begin(); !object.isEnd(); object.next())
+        {
+            writeName(os, object.getElemName(), object.getElemNameLength());
+            object.serializeElemValue(this, os);
+        }
+    }
+
+    // Member names
+    void writeName(Seza::Writer& os, const char* name, size_t length)
+    {
+        MsgPack::writeStringHeader(os, length);
+        os.write(name, length);
+    }
+
+    // Wide streams
+    void writeNull(std::wostream& os) { throw new MsgPack::MsgPackException(); }
+    template<typename Type> void writeValue(std::wostream& os, const Type& value) { throw new MsgPack::MsgPackException(); }
+    template<typename Type> void writeString(std::wostream& os, const Type& value) { throw new MsgPack::MsgPackException(); }
+    template<typename Type> void writeArray(std::wostream& os, const Type* vector, const size_t& size) { throw new MsgPack::MsgPackException(); }
+    template<typename Container> void writeSTLContainer(std::wostream& os, const Container& container) { throw new MsgPack::MsgPackException(); }
+    template<typename Object> void writeSerializable(std::wostream& os, const Object& object) { throw new MsgPack::MsgPackException(); }
+
+    /** Set while writing the pairs of a map **/
+    bool _entry;
+};
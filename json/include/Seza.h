@@ -28,25 +28,39 @@
 
 #pragma once;
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <array>
 #include <deque>
 #include <exception>
 #include <forward_list>
+#include <iterator>
 #include <istream>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <queue>
 #include <set>
 #include <stack>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+#include "SezaReader.h"
+#include "SezaStringPool.h"
+#include "SezaWriter.h"
 
 namespace Seza
 {
@@ -59,37 +73,62 @@ namespace Seza
     class Deserializer;
     class Serializable;
     class SerializableSTLContainer;
+    template<class C> class SerializerImpl;
+    template<class C> class DeserializerImpl;
 
     /* -- MACROS TO REGISTER A CLASS AS A SERIALIZABLE -- */
 
     /** Macro for clases with no members serializables **/
-#define NO_MEMBERS ;
+#define NO_MEMBERS
 
     /** Macro for serializable member **/
 #define ADD_MEMBER(name, type) \
-        _members[#name] = new RefMember<type>(instance.name);
+        Member<InstanceType, type, &InstanceType::name>(#name, sizeof(#name) - 1),
+
+    /** Macro for serializable member encoded with a number codec. The codec is used by the binary
+    encodings for std::vector members of 32 or 64 bits numbers **/
+#define ADD_MEMBER_CODEC(name, type, codec) \
+        CodecMember<InstanceType, type, &InstanceType::name, codec>(#name, sizeof(#name) - 1),
+
+    /** Macro to declare that the layout of a registered class is trivially copyable. Contiguous
+    containers of the class are copied as raw bytes by the binary encodings **/
+#define REGISTER_TRIVIAL_LAYOUT(className) \
+    template<> \
+    struct TrivialLayout<className> \
+    { \
+        static_assert(std::is_trivially_copyable<className>::value, #className " is not trivially copyable"); \
+        static const bool value = true; \
+    };
 
-    /** Macro to define a class as serializable **/
+    /** Macro to define a class as serializable.
+    The members table is built once per class, the first time the class is serialized **/
 #define REGISTER_SERIALIZABLE(className, members) \
     template<> \
     class SerializableClass<className> : public Serializable \
     { \
     public: \
+        typedef className InstanceType; \
         SerializableClass(className& instance) : \
-            Serializable(), \
-            _instance(instance) \
+            Serializable(getMembers(), &instance) \
         { \
-            members \
         } \
         SerializableClass(const className& instance) : \
-            Serializable(), \
-            _instance(const_cast<className&>(instance)) \
+            Serializable(getMembers(), const_cast<className*>(&instance)) \
         { \
-            members \
         } \
-        char const *getClassName() const { return #className; } \
-    protected: \
-        className& _instance; \
+        char const *getClassName() const { return getName(); } \
+        static char const *getName() { return #className; } \
+        static const MemberTable& getMembers() \
+        { \
+            static const MemberDescriptor descriptors[] = { members MemberDescriptor() }; \
+            static const MemberTable table(descriptors); \
+            return table; \
+        } \
+        template<typename V> \
+        static void visitMember(size_t index, const V& visitor) \
+        { \
+            visitMemberAt(index, visitor, members MemberEnd()); \
+        } \
     };
 
 
@@ -99,7 +138,28 @@ namespace Seza
     class OutOfRangeException : public std::exception 
     {
     public:
-      const char* what() const { return "Out of range in STL container!\n"; }
+      const char* what() const throw() { return "Out of range in STL container!\n"; }
+    };
+
+    /** This exception is thrown when a range or a generator is deserialized **/
+    class WriteOnlyException : public std::exception 
+    {
+    public:
+      const char* what() const throw() { return "Ranges and generators can only be serialized!\n"; }
+    };
+
+    /** This exception is thrown when a format writes the size of a range or a generator that cannot be known **/
+    class UnknownSizeException : public std::exception 
+    {
+    public:
+      const char* what() const throw() { return "The size of the range is unknown!\n"; }
+    };
+
+    /** This exception is thrown when the input is nested deeper than the stack limit of a deserializer **/
+    class StackLimitException : public std::exception 
+    {
+    public:
+      const char* what() const throw() { return "The input is nested deeper than the stack!\n"; }
     };
 
     /* -- SERIALIZABLE STL CONTAINER CLASS -- */
@@ -113,11 +173,159 @@ namespace Seza
         container_type &getContainer() { return this->c; }
     };
 
+    /* -- NUMBER CODECS -- */
+
+    /** Compression of vectors of numbers in the binary encodings **/
+    enum NumberCodec
+    {
+        /** Elements are written one by one **/
+        noCodec,
+        /** Differences between consecutive elements as zigzag varints. For sorted data like timestamps **/
+        deltaCodec,
+        /** Elements as zigzag varints. For small ids and counters **/
+        varintCodec,
+        /** Blocks of elements bit packed as offsets from their minimum **/
+        frameOfReferenceCodec,
+        /** XOR with the previous element, with its leading and trailing zeros elided. For floats **/
+        xorCodec
+    };
+
+    /** Element types that the number codecs encode **/
+    enum NumberType
+    {
+        noNumbers,
+        int32Numbers,
+        uint32Numbers,
+        int64Numbers,
+        uint64Numbers,
+        float32Numbers,
+        float64Numbers
+    };
+
+    template<typename T>
+    constexpr NumberType numberType()
+    {
+        return std::is_same<T, bool>::value ? noNumbers :
+            std::is_floating_point<T>::value ? (sizeof(T) == 4 ? float32Numbers : sizeof(T) == 8 ? float64Numbers : noNumbers) :
+            !std::is_integral<T>::value ? noNumbers :
+            (sizeof(T) == 4) ? (std::is_signed<T>::value ? int32Numbers : uint32Numbers) :
+            (sizeof(T) == 8) ? (std::is_signed<T>::value ? int64Numbers : uint64Numbers) : noNumbers;
+    }
+
+    /** Contiguous elements of a container of numbers **/
+    struct Numbers
+    {
+        NumberType type;
+        void* data;
+        size_t size;
+    };
+
+    /* -- BLOCKS -- */
+
+    /** Classes are not copied as raw bytes unless they are declared with REGISTER_TRIVIAL_LAYOUT **/
+    template<class C>
+    struct TrivialLayout
+    {
+        static const bool value = false;
+    };
+
+    /** Contiguous elements that can be copied as raw bytes **/
+    struct Block
+    {
+        /** Type of the elements **/
+        const std::type_info* type;
+        /** The elements are a class declared with REGISTER_TRIVIAL_LAYOUT **/
+        bool trivialLayout;
+        size_t elementSize;
+        void* data;
+        size_t size;
+    };
+
+    template<typename T>
+    struct BlockElement
+    {
+        static const bool value = (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || TrivialLayout<T>::value;
+    };
+
+    template<typename T>
+    inline bool makeBlock(T* data, size_t size, Block& block)
+    {
+        block.type = &typeid(T);
+        block.trivialLayout = TrivialLayout<T>::value;
+        block.elementSize = sizeof(T);
+        block.data = data;
+        block.size = size;
+        return true;
+    }
+
+    /* -- RESERVATION -- */
+
+    /** Containers with a reserve method: vectors, strings and unordered containers **/
+    template<typename C>
+    struct Reservable
+    {
+        template<typename U> static char test(decltype(std::declval<U&>().reserve(0))*);
+        template<typename U> static long test(...);
+        static const bool value = (sizeof(test<C>(0)) == 1);
+    };
+
+    template<typename C>
+    inline void reserveElements(C& container, size_t size, typename std::enable_if<Reservable<C>::value>::type* = 0)
+    {
+        container.reserve(container.size() + size);
+    }
+    template<typename C>
+    inline void reserveElements(C& container, size_t size, typename std::enable_if<!Reservable<C>::value>::type* = 0)
+    {
+    }
+
+    /* -- ALLOCATORS -- */
+
+    /** Creates the elements read by the containers with the allocator of the container (uses-allocator
+    construction). Nested pmr strings and containers are allocated in the memory resource of the 
+    container, and moved into it without copies **/
+    template<typename T>
+    struct ElementFactory
+    {
+        template<typename A>
+        static T make(const A& allocator) { return make(allocator, Construction<A>()); }
+
+    private:
+        template<typename A>
+        using Construction = std::integral_constant<int, !std::uses_allocator<T, A>::value ? 0 : 
+            std::is_constructible<T, std::allocator_arg_t, const A&>::value ? 1 : 
+            std::is_constructible<T, const A&>::value ? 2 : 0>;
+
+        template<typename A>
+        static T make(const A& allocator, std::integral_constant<int, 0>) { return T(); }
+        template<typename A>
+        static T make(const A& allocator, std::integral_constant<int, 1>) { return T(std::allocator_arg, allocator); }
+        template<typename A>
+        static T make(const A& allocator, std::integral_constant<int, 2>) { return T(allocator); }
+    };
+
+    /** Pairs give the allocator to both members **/
+    template<typename K, typename T>
+    struct ElementFactory<std::pair<K, T> >
+    {
+        template<typename A>
+        static std::pair<K, T> make(const A& allocator)
+        {
+            return std::pair<K, T>(std::piecewise_construct, 
+                std::forward_as_tuple(ElementFactory<K>::make(allocator)), 
+                std::forward_as_tuple(ElementFactory<T>::make(allocator)));
+        }
+    };
+
+    template<typename T, typename A>
+    inline T makeElement(const A& allocator) { return ElementFactory<T>::make(allocator); }
+
     /** Serializable STL container**/
     class SerializableSTLContainer
     {
     public:
-        SerializableSTLContainer(const std::string& name) : _name(name) {}
+        /** The name is a string literal, so containers are built without allocations **/
+        SerializableSTLContainer(const char* name) : _name(name) {}
 
         /** Returns the size of the container **/
         virtual size_t size() const = 0;
@@ -130,19 +338,43 @@ namespace Seza
         /** Checks if the iterator is set to the end **/
         virtual bool isEnd() const = 0;
 
-        /** Returns the name of the STL container **/
-        virtual const std::string& getClassName() const { return _name; }
+        /** Returns the name of the STL container. The string is only built when it is asked for **/
+        virtual const std::string& getClassName() const 
+        { 
+            if(_className.empty())
+                _className = _name;
+            return _className; 
+        }
+        /** Checks if the elements are key-value pairs **/
+        virtual bool isMap() const { return false; }
+        /** Returns the codec for the elements **/
+        virtual NumberCodec getCodec() const { return noCodec; }
+        /** Gets the elements if they are contiguous numbers **/
+        virtual bool getNumbers(Numbers& numbers) const { return false; }
+        /** Resizes the container to size contiguous numbers to be decoded in place. Returns false, 
+        without resizing, if the elements are not contiguous numbers **/
+        virtual bool resizeNumbers(size_t size, Numbers& numbers) const { return false; }
+        /** Gets the elements if they are contiguous and can be copied as raw bytes **/
+        virtual bool getBlock(Block& block) const { return false; }
+        /** Resizes the container to size contiguous elements to be copied in place. Returns false, 
+        without resizing, if the elements cannot be copied as raw bytes **/
+        virtual bool resizeBlock(size_t size, Block& block) const { return false; }
+        /** Checks if the container can reserve room for its elements, so it is worth counting them **/
+        virtual bool isReservable() const { return false; }
+        /** Reserves room for size more elements, when the format knows how many follow **/
+        virtual void reserve(size_t size) const {}
         /** Serializes the element of the container pointed by the iterator **/
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const = 0;
+        virtual void serializeElem(Serializer* sez, Writer& os) const = 0;
         /** Serializes the element of the container pointed by the iterator **/
         virtual void serializeElem(Serializer* sez, std::wostream& os) const = 0;
         /** Deserializes the element of the container pointed by the iterator **/
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const = 0;
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const = 0;
         /** Deserializes the element of the container pointed by the iterator **/
         virtual void deserializeElem(Deserializer* dez, std::wistream& is) const = 0;
 
     protected:
-        std::string _name;
+        const char* _name;
+        mutable std::string _className;
     };
 
     /** Serializable STL pair**/
@@ -150,7 +382,7 @@ namespace Seza
     class SerializableSTLPair : public SerializableSTLContainer
     {
     public:
-        SerializableSTLPair(std::pair<K, T>& instance, const std::string& name) : 
+        SerializableSTLPair(std::pair<K, T>& instance, const char* name) : 
             _instance(instance), 
             _it(0),
             _pos(0), 
@@ -163,7 +395,7 @@ namespace Seza
         virtual bool isBegin() const { return (_it == 0); }
         virtual bool isEnd() const { return (_it == 2); }
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const 
+        virtual void serializeElem(Serializer* sez, Writer& os) const 
         {
             if(_it == 0)
                 sez->write(os, _instance.first); 
@@ -181,7 +413,7 @@ namespace Seza
             else
                 throw OutOfRangeException();
         }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const 
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const 
         { 
             if(_pos == 0)
                 dez->read(is, _instance.first);
@@ -207,40 +439,146 @@ namespace Seza
         mutable size_t _pos;
     };
 
-    /** Serializable deque and list **/
+    /** Serializable constant STL pair, like the entries of a map. Pairs are written in place, so they 
+    are not read **/
+    template<typename K, typename T>
+    class SerializableSTLConstPair final : public SerializableSTLContainer
+    {
+    public:
+        SerializableSTLConstPair(const std::pair<K, T>& instance) : 
+            _instance(instance), 
+            _it(0),
+            SerializableSTLContainer("std::pair")
+        {
+        }
+        virtual size_t size() const { return 2; }
+        virtual void begin() const { _it = 0; }
+        virtual void next() const { ++_it; }
+        virtual bool isBegin() const { return (_it == 0); }
+        virtual bool isEnd() const { return (_it == 2); }
+
+        virtual void serializeElem(Serializer* sez, Writer& os) const { writeElem(sez, os); }
+        virtual void serializeElem(Serializer* sez, std::wostream& os) const { writeElem(sez, os); }
+        /** Statically dispatched elements **/
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const 
+        {
+            if(_it == 0)
+                sez->writeStatic(os, _instance.first); 
+            else if(_it == 1)
+                sez->writeStatic(os, _instance.second);
+            else
+                throw OutOfRangeException();
+        }
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const { throw WriteOnlyException(); }
+        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const { throw WriteOnlyException(); }
+    protected:
+        template<typename Stream>
+        void writeElem(Serializer* sez, Stream& os) const
+        {
+            if(_it == 0)
+                sez->write(os, _instance.first); 
+            else if(_it == 1)
+                sez->write(os, _instance.second);
+            else
+                throw OutOfRangeException();
+        }
+
+        const std::pair<K, T>& _instance;
+        mutable unsigned int _it;
+    };
+
+    /** Serializable vector, deque and list **/
     template<typename C, typename T>
     class SerializableSTLList : public SerializableSTLContainer
     {
     public:
-        SerializableSTLList(C& instance, const std::string& name) : 
+        SerializableSTLList(C& instance, const char* name, NumberCodec codec = noCodec) : 
             _instance(instance), 
             _it(_instance.begin()), 
+            _codec(codec),
             SerializableSTLContainer(name)
         {
         }
         virtual size_t size() const { return _instance.size(); }
+        virtual NumberCodec getCodec() const { return _codec; }
+        virtual bool getNumbers(Numbers& numbers) const { return contiguousNumbers(_instance, numbers); }
+        virtual bool resizeNumbers(size_t size, Numbers& numbers) const
+        {
+            if(!contiguousNumbers(_instance, numbers))
+                return false;
+            _instance.resize(size);
+            return contiguousNumbers(_instance, numbers);
+        }
+        virtual bool getBlock(Block& block) const { return contiguousBlock(_instance, block); }
+        virtual bool resizeBlock(size_t size, Block& block) const
+        {
+            if(!contiguousBlock(_instance, block))
+                return false;
+            _instance.resize(size);
+            return contiguousBlock(_instance, block);
+        }
+        virtual bool isReservable() const { return Reservable<C>::value; }
+        virtual void reserve(size_t size) const { reserveElements(_instance, size); }
         virtual void begin() const { _it = _instance.begin(); }
         virtual void next() const { ++_it; }
         virtual bool isBegin() const { return (_it == _instance.begin()); }
         virtual bool isEnd() const { return (_it == _instance.end()); }
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const { sez->write(os, *_it); }
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, *_it); }
         virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, *_it); }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const 
-        { 
-            T tmp;
-            dez->read(is, tmp);
-            _instance.push_back(tmp);
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const { readBack(dez, is, InPlace()); }
+        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const { readBack(dez, is, InPlace()); }
+    protected:
+        /** Elements are constructed in place and read into the container, except the bits of 
+        vector<bool> that cannot be referenced. Elements that are not read are removed **/
+        typedef std::is_same<typename C::reference, T&> InPlace;
+        template<typename Stream>
+        void readBack(Deserializer* dez, Stream& is, std::true_type) const
+        {
+            _instance.emplace_back();
+            try
+            {
+                dez->read(is, _instance.back());
+            }
+            catch(...)
+            {
+                _instance.pop_back();
+                throw;
+            }
         }
-        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const 
-        { 
+        template<typename Stream>
+        void readBack(Deserializer* dez, Stream& is, std::false_type) const
+        {
             T tmp;
             dez->read(is, tmp);
-            _instance.push_back(tmp);
+            _instance.push_back(std::move(tmp));
         }
-    protected:
+
+        /** Only vectors store their elements contiguously **/
+        template<typename V>
+        static bool contiguousNumbers(V& container, Numbers& numbers) { return false; }
+        template<typename E, typename A>
+        static typename std::enable_if<numberType<E>() != noNumbers, bool>::type 
+            contiguousNumbers(std::vector<E, A>& container, Numbers& numbers)
+        {
+            numbers.type = numberType<E>();
+            numbers.data = container.data();
+            numbers.size = container.size();
+            return true;
+        }
+        template<typename V>
+        static bool contiguousBlock(V& container, Block& block) { return false; }
+        template<typename E, typename A>
+        static typename std::enable_if<BlockElement<E>::value, bool>::type 
+            contiguousBlock(std::vector<E, A>& container, Block& block)
+        {
+            return makeBlock(container.data(), container.size(), block);
+        }
+
         C& _instance;
         mutable typename C::const_iterator _it;
+        NumberCodec _codec;
     };
 
     /** Serializable array **/
@@ -248,7 +586,7 @@ namespace Seza
     class SerializableSTLList<std::array<T, N>, T> : public SerializableSTLContainer
     {
     public:
-        SerializableSTLList(std::array<T, N>& instance, const std::string& name) : 
+        SerializableSTLList(std::array<T, N>& instance, const char* name) : 
             _instance(instance), 
             _it(_instance.begin()), 
             _pos(0), 
@@ -256,29 +594,28 @@ namespace Seza
         {
         }
         virtual size_t size() const { return _instance.size(); }
+        virtual bool getBlock(Block& block) const { return BlockElement<T>::value && makeBlock(_instance.data(), N, block); }
+        /** Arrays are not resized: only blocks of N elements are copied **/
+        virtual bool resizeBlock(size_t size, Block& block) const { return (size == N) && getBlock(block); }
         virtual void begin() const { _it = _instance.begin(); }
         virtual void next() const { ++_it; }
         virtual bool isBegin() const { return (_it == _instance.begin()); }
         virtual bool isEnd() const { return (_it == _instance.end()); }
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const { sez->write(os, *_it); }
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, *_it); }
         virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, *_it); }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const 
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const 
         { 
-            if(_pos > _instance.size())
+            if(_pos >= _instance.size())
                 throw OutOfRangeException();
-            T tmp;
-            dez->read(is, tmp);
-            _instance[_pos] = tmp;
+            dez->read(is, _instance[_pos]);
             _pos++;
         }
         virtual void deserializeElem(Deserializer* dez, std::wistream& is) const 
         { 
-            if(_pos > _instance.size())
+            if(_pos >= _instance.size())
                 throw OutOfRangeException();
-            T tmp;
-            dez->read(is, tmp);
-            _instance[_pos] = tmp;
+            dez->read(is, _instance[_pos]);
             _pos++;
         }
     protected:
@@ -289,39 +626,45 @@ namespace Seza
     };
 
     /** Serializable forward list **/
-    template<typename T>
-    class SerializableSTLList<std::forward_list<T>, T > : public SerializableSTLContainer
+    template<typename T, typename A>
+    class SerializableSTLList<std::forward_list<T, A>, T > : public SerializableSTLContainer
     {
     public:
-        SerializableSTLList(std::forward_list<T>& instance, const std::string& name) : 
+        SerializableSTLList(std::forward_list<T, A>& instance, const char* name) : 
             _instance(instance), 
             _it(_instance.begin()), 
             SerializableSTLContainer(name)
         {
         }
-        virtual size_t size() const { return _instance.max_size(); }
+        virtual size_t size() const { return (size_t)std::distance(_instance.begin(), _instance.end()); }
         virtual void begin() const { _it = _instance.begin(); }
         virtual void next() const { ++_it; }
         virtual bool isBegin() const { return (_it == _instance.begin()); }
         virtual bool isEnd() const { return (_it == _instance.end()); }
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const { sez->write(os, *_it); }
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, *_it); }
         virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, *_it); }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const 
-        { 
-            T tmp;
-            dez->read(is, tmp);
-            _instance.push_front(tmp);
-        }
-        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const 
-        { 
-            T tmp;
-            dez->read(is, tmp);
-            _instance.push_front(tmp);
-        }
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const { readFront(dez, is); }
+        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const { readFront(dez, is); }
     protected:
-        std::forward_list<T>& _instance;
-        mutable typename std::forward_list<T>::const_iterator _it;
+        /** Elements that are not read are removed **/
+        template<typename Stream>
+        void readFront(Deserializer* dez, Stream& is) const
+        {
+            _instance.emplace_front();
+            try
+            {
+                dez->read(is, _instance.front());
+            }
+            catch(...)
+            {
+                _instance.pop_front();
+                throw;
+            }
+        }
+
+        std::forward_list<T, A>& _instance;
+        mutable typename std::forward_list<T, A>::const_iterator _it;
     };
 
     /** Serializable map **/
@@ -329,39 +672,36 @@ namespace Seza
     class SerializableSTLMap : public SerializableSTLContainer
     {
     public:
-        SerializableSTLMap(C& instance, const std::string& name) : 
+        SerializableSTLMap(C& instance, const char* name) : 
             _instance(instance), 
             _it(_instance.begin()), 
             SerializableSTLContainer(name)
         {
         }
+        virtual bool isMap() const { return true; }
+        virtual bool isReservable() const { return Reservable<C>::value; }
+        virtual void reserve(size_t size) const { reserveElements(_instance, size); }
         virtual size_t size() const { return _instance.size(); }
         virtual void begin() const { _it = _instance.begin(); }
         virtual void next() const { ++_it; }
         virtual bool isBegin() const { return (_it == _instance.begin()); }
         virtual bool isEnd() const { return (_it == _instance.end()); }
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const 
-        { 
-            std::pair<K, T> tmp = (*_it);
-            sez->write(os, tmp); 
-        }
-        virtual void serializeElem(Serializer* sez, std::wostream& os) const
-        { 
-            std::pair<K, T> tmp = (*_it);
-            sez->write(os, tmp); 
-        }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const 
+        /** Entries are written in place, as pairs with a constant key **/
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, *_it); }
+        virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, *_it); }
+        /** Entries are moved into the container **/
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const 
         { 
-            std::pair<K, T> tmp;
+            std::pair<K, T> tmp(makeElement<std::pair<K, T> >(_instance.get_allocator()));
             dez->read(is, tmp);
-            _instance.insert(tmp);
+            _instance.insert(std::move(tmp));
         }
         virtual void deserializeElem(Deserializer* dez, std::wistream& is) const 
         { 
-            std::pair<K, T> tmp;
+            std::pair<K, T> tmp(makeElement<std::pair<K, T> >(_instance.get_allocator()));
             dez->read(is, tmp);
-            _instance.insert(tmp);
+            _instance.insert(std::move(tmp));
         }
     protected:
         C& _instance;
@@ -373,31 +713,33 @@ namespace Seza
     class SerializableSTLSet : public SerializableSTLContainer
     {
     public:
-        SerializableSTLSet(C& instance, const std::string& name) : 
+        SerializableSTLSet(C& instance, const char* name) : 
             _instance(instance), 
             _it(_instance.begin()), 
             SerializableSTLContainer(name)
         {
         }
+        virtual bool isReservable() const { return Reservable<C>::value; }
+        virtual void reserve(size_t size) const { reserveElements(_instance, size); }
         virtual size_t size() const { return _instance.size(); }
         virtual void begin() const { _it = _instance.begin(); }
         virtual void next() const { ++_it; }
         virtual bool isBegin() const { return (_it == _instance.begin()); }
         virtual bool isEnd() const { return (_it == _instance.end()); }
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const { sez->write(os, *_it); }
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, *_it); }
         virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, *_it); }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const 
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const 
         { 
-            T tmp;
+            T tmp(makeElement<T>(_instance.get_allocator()));
             dez->read(is, tmp);
-            _instance.insert(tmp);
+            _instance.insert(std::move(tmp));
         }
         virtual void deserializeElem(Deserializer* dez, std::wistream& is) const 
         { 
-            T tmp;
+            T tmp(makeElement<T>(_instance.get_allocator()));
             dez->read(is, tmp);
-            _instance.insert(tmp);
+            _instance.insert(std::move(tmp));
         }
     protected:
         C& _instance;
@@ -409,31 +751,33 @@ namespace Seza
     class SerializableSTLQueue : public SerializableSTLContainer
     {
     public:
-        SerializableSTLQueue(C& instance, const std::string& name) : 
+        SerializableSTLQueue(C& instance, const char* name) : 
             _instance(instance), 
             SerializableSTLContainer(name)
         {
              _adapter = reinterpret_cast<Adapter<C> *>(&instance);
         }
         virtual size_t size() const { return _instance.size(); }
+        virtual bool isReservable() const { return Reservable<typename Adapter<C>::container_type>::value; }
+        virtual void reserve(size_t size) const { reserveElements(_adapter->getContainer(), size); }
         virtual void begin() const { _it = _adapter->getContainer().begin(); }
         virtual void next() const { ++_it; }
         virtual bool isBegin() const { return (_it == _adapter->getContainer().begin()); }
         virtual bool isEnd() const { return (_it == _adapter->getContainer().end()); }
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const { sez->write(os, *_it); }
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, *_it); }
         virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, *_it); }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const 
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const 
         { 
-            T tmp;
+            T tmp(makeElement<T>(_adapter->getContainer().get_allocator()));
             dez->read(is, tmp);
-            _instance.push(tmp);
+            _instance.push(std::move(tmp));
         }
         virtual void deserializeElem(Deserializer* dez, std::wistream& is) const 
         { 
-            T tmp;
+            T tmp(makeElement<T>(_adapter->getContainer().get_allocator()));
             dez->read(is, tmp);
-            _instance.push(tmp);
+            _instance.push(std::move(tmp));
         }
     protected:
         C& _instance;
@@ -441,50 +785,314 @@ namespace Seza
         mutable typename Adapter<C>::container_type::const_iterator _it;
     };
 
+    /* -- RANGES AND GENERATORS -- */
+
+    /** Size of the ranges and generators that do not know it in advance **/
+    const size_t unknownSize = (size_t)-1;
+
+    /** Range of elements serialized as an array, without a container. Elements are written as the 
+    iterators produce them, so input iterators over results still being computed are written with one 
+    element in memory. The formats that write the count first take it from std::distance, unless it is 
+    given, which input iterators need **/
+    template<typename It>
+    class SerializableRange final : public SerializableSTLContainer
+    {
+    public:
+        SerializableRange(It first, It last, size_t size = unknownSize) : 
+            SerializableSTLContainer("range"), 
+            _first(first), 
+            _last(last), 
+            _it(first), 
+            _pos(0), 
+            _size(size)
+        {
+        }
+        virtual size_t size() const { return (_size != unknownSize) ? _size : count(typename std::iterator_traits<It>::iterator_category()); }
+        virtual void begin() const { _it = _first; _pos = 0; }
+        virtual void next() const { ++_it; ++_pos; }
+        virtual bool isBegin() const { return (_pos == 0); }
+        virtual bool isEnd() const { return (_it == _last); }
+
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, *_it); }
+        virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, *_it); }
+        /** Statically dispatched elements **/
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, *_it); }
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const { throw WriteOnlyException(); }
+        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const { throw WriteOnlyException(); }
+    protected:
+        size_t count(std::forward_iterator_tag) const { return (size_t)std::distance(_first, _last); }
+        size_t count(std::input_iterator_tag) const { throw UnknownSizeException(); }
+
+        It _first;
+        It _last;
+        mutable It _it;
+        mutable size_t _pos;
+        size_t _size;
+    };
+
+    /** Generator of elements serialized as an array. The generator fills the next element and returns 
+    false when there are no more, so a single element is kept and reused. The size is only needed by 
+    the formats that write the count first **/
+    template<typename T, typename G>
+    class SerializableGenerator final : public SerializableSTLContainer
+    {
+    public:
+        SerializableGenerator(G generator, size_t size = unknownSize) : 
+            SerializableSTLContainer("generator"), 
+            _generator(generator), 
+            _element(), 
+            _more(false), 
+            _pos(0), 
+            _size(size)
+        {
+        }
+        virtual size_t size() const 
+        { 
+            if(_size == unknownSize)
+                throw UnknownSizeException();
+            return _size; 
+        }
+        /** The elements are generated once **/
+        virtual void begin() const { _more = _generator(_element); }
+        virtual void next() const { _more = _generator(_element); ++_pos; }
+        virtual bool isBegin() const { return (_pos == 0); }
+        virtual bool isEnd() const { return !_more; }
+
+        virtual void serializeElem(Serializer* sez, Writer& os) const { sez->write(os, _element); }
+        virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, _element); }
+        /** Statically dispatched elements **/
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, _element); }
+        virtual void deserializeElem(Deserializer* dez, Reader& is) const { throw WriteOnlyException(); }
+        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const { throw WriteOnlyException(); }
+    protected:
+        mutable G _generator;
+        mutable T _element;
+        mutable bool _more;
+        mutable size_t _pos;
+        size_t _size;
+    };
+
+    /** Ranges of iterators and of containers **/
+    template<typename It>
+    inline SerializableRange<It> makeRange(It first, It last, size_t size = unknownSize)
+    {
+        return SerializableRange<It>(first, last, size);
+    }
+    template<typename R>
+    inline SerializableRange<typename R::const_iterator> makeRange(const R& range)
+    {
+        return SerializableRange<typename R::const_iterator>(range.begin(), range.end());
+    }
+    /** Generators of elements of type T **/
+    template<typename T, typename G>
+    inline SerializableGenerator<T, G> makeGenerator(G generator, size_t size = unknownSize)
+    {
+        return SerializableGenerator<T, G>(generator, size);
+    }
+
     /* -- SERIALIZABLE CLASS -- */
 
-    /** Serializable class member **/
-    struct RefMemberBase
+    /** Type-erased description of a serializable class member **/
+    struct MemberDescriptor
     {
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const = 0;
-        virtual void serializeElem(Serializer* sez, std::wostream& os) const = 0;
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const = 0;
-        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const = 0;
+        /** Name of the member. The last descriptor of a table has a null name **/
+        const char* name;
+        /** Length of the member name **/
+        size_t nameLength;
+        /** Serializes the member of the instance **/
+        void (*serialize)(Serializer* sez, Writer& os, void* instance);
+        /** Serializes the member of the instance **/
+        void (*wserialize)(Serializer* sez, std::wostream& os, void* instance);
+        /** Deserializes the member of the instance **/
+        void (*deserialize)(Deserializer* dez, Reader& is, void* instance);
+        /** Deserializes the member of the instance **/
+        void (*wdeserialize)(Deserializer* dez, std::wistream& is, void* instance);
     };
 
-    /** Specialization fo a serializable class member **/
-    template<typename T>
-    class RefMember : public RefMemberBase
+    /** Codec for the member M of type T of the class C **/
+    template<class C, typename T, T C::*M>
+    struct Member
+    {
+        typedef T Type;
+
+        constexpr Member(const char* name, size_t nameLength) : 
+            _name(name), 
+            _nameLength(nameLength) 
+        {
+        }
+
+        static void serialize(Serializer* sez, Writer& os, void* instance);
+        static void serialize(Serializer* sez, std::wostream& os, void* instance);
+        static void deserialize(Deserializer* dez, Reader& is, void* instance);
+        static void deserialize(Deserializer* dez, std::wistream& is, void* instance);
+        /** Statically dispatched codec for the format F **/
+        template<class F, typename Stream>
+        static void writeStatic(F* sez, Stream& os, void* instance) { sez->writeStatic(os, static_cast<C*>(instance)->*M); }
+        template<class F, typename Stream>
+        static void readStatic(F* dez, Stream& is, void* instance) { dez->readStatic(is, static_cast<C*>(instance)->*M); }
+
+        constexpr operator MemberDescriptor() const
+        {
+            return MemberDescriptor{ _name, _nameLength, &serialize, &serialize, &deserialize, &deserialize };
+        }
+
+        const char* _name;
+        size_t _nameLength;
+    };
+
+    /** Codec for the member M of type T of the class C, whose elements are encoded with the number codec K **/
+    template<class C, typename T, T C::*M, NumberCodec K>
+    struct CodecMember : public Member<C, T, M>
+    {
+        constexpr CodecMember(const char* name, size_t nameLength) : 
+            Member<C, T, M>(name, nameLength)
+        {
+        }
+
+        static void serialize(Serializer* sez, Writer& os, void* instance);
+        static void deserialize(Deserializer* dez, Reader& is, void* instance);
+        /** Statically dispatched codec for the format F **/
+        template<class F, typename Stream>
+        static void writeStatic(F* sez, Stream& os, void* instance) { sez->writeStatic(os, static_cast<C*>(instance)->*M, K); }
+        template<class F, typename Stream>
+        static void readStatic(F* dez, Stream& is, void* instance) { dez->readStatic(is, static_cast<C*>(instance)->*M, K); }
+
+        constexpr operator MemberDescriptor() const
+        {
+            return MemberDescriptor{ this->_name, this->_nameLength, &serialize, &Member<C, T, M>::serialize, 
+                &deserialize, &Member<C, T, M>::deserialize };
+        }
+    };
+
+    /** Immutable table with the members of a serializable class.
+    Names are looked up through a perfect hash built when the table is created **/
+    class MemberTable
     {
     public:
-        RefMember(T& ref) : _ref(ref) {}
-        RefMember(const T& ref) : _ref(const_cast<T&>(ref)) {}
-        ~RefMember() { _ref = nullptr; }
+        /** Longest member name that can be looked up **/
+        static const size_t maxNameLength = 255;
+        /** Largest hash table. Tables without a perfect hash of this size are searched linearly **/
+        static const size_t maxHashSize = 1 << 16;
+
+        MemberTable() : _members(0), _count(0), _seed(0), _mask(0) {}
+        MemberTable(const MemberDescriptor* members) : 
+            _members(members), 
+            _count(0),
+            _seed(0),
+            _mask(0)
+        {
+            while(_members[_count].name != 0)
+                ++_count;
+            buildHash();
+        }
+
+        /** Returns the count of members **/
+        size_t size() const { return _count; }
+        /** Returns the first member **/
+        const MemberDescriptor* begin() const { return _members; }
+        /** Returns the past the end member **/
+        const MemberDescriptor* end() const { return _members + _count; }
+        /** Returns the member with the given name or null if it does not exist **/
+        const MemberDescriptor* find(const char* name, size_t length) const
+        {
+            if(_count == 0)
+                return 0;
+            if(_slots.empty())
+                return findLinear(name, length);
 
-        virtual void serializeElem(Serializer* sez, std::ostream& os) const { sez->write(os, _ref); }
-        virtual void serializeElem(Serializer* sez, std::wostream& os) const { sez->write(os, _ref); }
-        virtual void deserializeElem(Deserializer* dez, std::istream& is) const { dez->read(is, _ref); }
-        virtual void deserializeElem(Deserializer* dez, std::wistream& is) const { dez->read(is, _ref); }
+            unsigned int slot = _slots[hash(name, length, _seed) & _mask];
+            if(slot == 0)
+                return 0;
+
+            const MemberDescriptor* member = &_members[slot - 1];
+            if((member->nameLength != length) || (memcmp(member->name, name, length) != 0))
+                return 0;
+
+            return member;
+        }
 
     protected:
-        T& _ref;
+        /** Seeded FNV-1a hash of a member name **/
+        static unsigned int hash(const char* name, size_t length, unsigned int seed)
+        {
+            unsigned int value = 2166136261u ^ seed;
+            for(size_t i = 0; i < length; ++i)
+                value = (value ^ (unsigned char)name[i]) * 16777619u;
+            return value ^ (value >> 15);
+        }
+
+        /** Returns the first declared member with the name **/
+        const MemberDescriptor* findLinear(const char* name, size_t length) const
+        {
+            for(size_t i = 0; i < _count; ++i)
+            {
+                if((_members[i].nameLength == length) && (memcmp(_members[i].name, name, length) == 0))
+                    return &_members[i];
+            }
+            return 0;
+        }
+
+        /** Searches a seed and a table size without collisions among the member names. If there 
+        is none up to maxHashSize, the table is left empty and the names are searched linearly **/
+        void buildHash()
+        {
+            if(_count == 0)
+                return;
+
+            size_t size = 1;
+            while(size < 2 * _count)
+                size <<= 1;
+
+            for(; size <= maxHashSize; size <<= 1)
+            {
+                _mask = (unsigned int)(size - 1);
+                for(_seed = 1; _seed <= 64; ++_seed)
+                {
+                    _slots.assign(size, 0);
+
+                    size_t i;
+                    for(i = 0; i < _count; ++i)
+                    {
+                        unsigned int& slot = _slots[hash(_members[i].name, _members[i].nameLength, _seed) & _mask];
+                        if(slot == 0)
+                            slot = (unsigned int)(i + 1);
+                        else if(strcmp(_members[slot - 1].name, _members[i].name) != 0)
+                            break; // A repeated member keeps its first declaration
+                    }
+
+                    if(i == _count)
+                        return;
+                }
+            }
+            _slots.clear();
+            _seed = 0;
+            _mask = 0;
+        }
+
+        const MemberDescriptor* _members;
+        size_t _count;
+        unsigned int _seed;
+        unsigned int _mask;
+        std::vector<unsigned int> _slots; // member index + 1, 0 if the slot is empty
     };
 
     /** Serializable class**/
     class Serializable
     {
     public:
-        Serializable()
+        Serializable() : 
+            _members(emptyMembers()), 
+            _instance(0), 
+            _it(0)
         {
         }
-        ~Serializable()
+        Serializable(const MemberTable& members, void* instance) : 
+            _members(members), 
+            _instance(instance), 
+            _it(0)
         {
-            for(std::map<std::string, RefMemberBase*>::iterator it = _members.begin();
-                it != _members.end(); ++it)
-            {
-                delete it->second;
-            }
-            _members.clear();
         }
 
         /** Returns the count of the serializable class members **/
@@ -500,87 +1108,371 @@ namespace Seza
 
         /** Returns the name of the serializable class **/
         virtual const char *getClassName() const = 0;
-        /** Serializes the member name of the container pointed by the iterator **/
-        virtual void serializeElemName(Serializer* sez, std::ostream& os) const;
-        /** Serializes the member name of the container pointed by the iterator **/
-        virtual void serializeElemName(Serializer* sez, std::wostream& os) const;
+        /** Returns the member name pointed by the iterator **/
+        virtual const char *getElemName() const { return _it->name; }
+        /** Returns the length of the member name pointed by the iterator **/
+        virtual size_t getElemNameLength() const { return _it->nameLength; }
+        /** Returns the position of the member pointed by the iterator in the members table **/
+        virtual size_t getElemIndex() const { return (size_t)(_it - _members.begin()); }
         /** Serializes the member value of the container pointed by the iterator **/
-        virtual void serializeElemValue(Serializer* sez, std::ostream& os) const;
+        virtual void serializeElemValue(Serializer* sez, Writer& os) const;
         /** Serializes the member value of the container pointed by the iterator **/
         virtual void serializeElemValue(Serializer* sez, std::wostream& os) const;
         /** Returns true if the member name deserializated exists in the class **/
-        virtual bool deserializeElemName(Deserializer* dez, std::istream& is) const;
+        virtual bool deserializeElemName(Deserializer* dez, Reader& is) const;
         /** Returns true if the member name deserializated exists in the class **/
         virtual bool deserializeElemName(Deserializer* dez, std::wistream& is) const;
         /** Deserializes the member value of the container pointed by the iterator **/
-        virtual void deserializeElemValue(Deserializer* dez, std::istream& is) const;
+        virtual void deserializeElemValue(Deserializer* dez, Reader& is) const;
         /** Deserializes the member value of the container pointed by the iterator **/
         virtual void deserializeElemValue(Deserializer* dez, std::wistream& is) const;
 
-    protected:
-        std::map<std::string, RefMemberBase*> _members;
-        mutable std::map<std::string, RefMemberBase*>::const_iterator _it;
+    protected:
+        static const MemberTable& emptyMembers()
+        {
+            static const MemberTable table;
+            return table;
+        }
+
+        const MemberTable& _members;
+        void* _instance;
+        mutable const MemberDescriptor* _it;
+    };
+
+    /** Specialization fo a serializable class **/
+    template<class C>
+    class SerializableClass : public Serializable
+    {
+    public:
+        /** Also valid for const types, like the keys of the entries of a map **/
+        SerializableClass(const C& instance) : 
+            Serializable()
+        {
+        }
+    };
+
+    /* -- STATICALLY DISPATCHED CONTAINERS -- */
+
+    /** The static adaptors hide the virtual element methods with templates on the format, so the
+    format hooks called with a final adaptor resolve the whole call tree at compile time **/
+
+    /** Statically dispatched STL pair **/
+    template<typename K, typename T>
+    class StaticSTLPair final : public SerializableSTLPair<K, T>
+    {
+    public:
+        StaticSTLPair(std::pair<K, T>& instance, const char* name) : 
+            SerializableSTLPair<K, T>(instance, name)
+        {
+        }
+
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const 
+        {
+            if(this->_it == 0)
+                sez->writeStatic(os, this->_instance.first); 
+            else if(this->_it == 1)
+                sez->writeStatic(os, this->_instance.second);
+            else
+                throw OutOfRangeException();
+        }
+        template<class F, typename Stream>
+        void deserializeElem(F* dez, Stream& is) const 
+        { 
+            if(this->_pos == 0)
+                dez->readStatic(is, this->_instance.first);
+            else if(this->_pos == 1)
+                dez->readStatic(is, this->_instance.second);
+            else
+                throw OutOfRangeException();
+            this->_pos++;
+        }
+    };
+
+    /** Statically dispatched vector, deque and list **/
+    template<typename C, typename T>
+    class StaticSTLList final : public SerializableSTLList<C, T>
+    {
+    public:
+        StaticSTLList(C& instance, const char* name, NumberCodec codec = noCodec) : 
+            SerializableSTLList<C, T>(instance, name, codec)
+        {
+        }
+
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, *this->_it); }
+        template<class F, typename Stream>
+        void deserializeElem(F* dez, Stream& is) const { readBack(dez, is, typename SerializableSTLList<C, T>::InPlace()); }
+
+    protected:
+        template<class F, typename Stream>
+        void readBack(F* dez, Stream& is, std::true_type) const
+        {
+            this->_instance.emplace_back();
+            try
+            {
+                dez->readStatic(is, this->_instance.back());
+            }
+            catch(...)
+            {
+                this->_instance.pop_back();
+                throw;
+            }
+        }
+        template<class F, typename Stream>
+        void readBack(F* dez, Stream& is, std::false_type) const
+        {
+            T tmp;
+            dez->readStatic(is, tmp);
+            this->_instance.push_back(std::move(tmp));
+        }
+    };
+
+    /** Statically dispatched array **/
+    template<typename T, size_t N>
+    class StaticSTLList<std::array<T, N>, T> final : public SerializableSTLList<std::array<T, N>, T>
+    {
+    public:
+        StaticSTLList(std::array<T, N>& instance, const char* name) : 
+            SerializableSTLList<std::array<T, N>, T>(instance, name)
+        {
+        }
+
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, *this->_it); }
+        template<class F, typename Stream>
+        void deserializeElem(F* dez, Stream& is) const 
+        { 
+            if(this->_pos >= N)
+                throw OutOfRangeException();
+            dez->readStatic(is, this->_instance[this->_pos]);
+            this->_pos++;
+        }
+    };
+
+    /** Statically dispatched forward list **/
+    template<typename T, typename A>
+    class StaticSTLList<std::forward_list<T, A>, T> final : public SerializableSTLList<std::forward_list<T, A>, T>
+    {
+    public:
+        StaticSTLList(std::forward_list<T, A>& instance, const char* name) : 
+            SerializableSTLList<std::forward_list<T, A>, T>(instance, name)
+        {
+        }
+
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, *this->_it); }
+        template<class F, typename Stream>
+        void deserializeElem(F* dez, Stream& is) const 
+        { 
+            this->_instance.emplace_front();
+            try
+            {
+                dez->readStatic(is, this->_instance.front());
+            }
+            catch(...)
+            {
+                this->_instance.pop_front();
+                throw;
+            }
+        }
+    };
+
+    /** Statically dispatched map. Entries are written without copying them to a pair **/
+    template<typename C, typename K, typename T>
+    class StaticSTLMap final : public SerializableSTLMap<C, K, T>
+    {
+    public:
+        StaticSTLMap(C& instance, const char* name) : 
+            SerializableSTLMap<C, K, T>(instance, name)
+        {
+        }
+
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, *this->_it); }
+        template<class F, typename Stream>
+        void deserializeElem(F* dez, Stream& is) const 
+        { 
+            std::pair<K, T> tmp(makeElement<std::pair<K, T> >(this->_instance.get_allocator()));
+            dez->readStatic(is, tmp);
+            this->_instance.insert(std::move(tmp));
+        }
+    };
+
+    /** Statically dispatched set and multiset **/
+    template<typename C, typename T>
+    class StaticSTLSet final : public SerializableSTLSet<C, T>
+    {
+    public:
+        StaticSTLSet(C& instance, const char* name) : 
+            SerializableSTLSet<C, T>(instance, name)
+        {
+        }
+
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, *this->_it); }
+        template<class F, typename Stream>
+        void deserializeElem(F* dez, Stream& is) const 
+        { 
+            T tmp(makeElement<T>(this->_instance.get_allocator()));
+            dez->readStatic(is, tmp);
+            this->_instance.insert(std::move(tmp));
+        }
+    };
+
+    /** Statically dispatched stack, queue and priority queue **/
+    template<typename C, typename T>
+    class StaticSTLQueue final : public SerializableSTLQueue<C, T>
+    {
+    public:
+        StaticSTLQueue(C& instance, const char* name) : 
+            SerializableSTLQueue<C, T>(instance, name)
+        {
+        }
+
+        template<class F, typename Stream>
+        void serializeElem(F* sez, Stream& os) const { sez->writeStatic(os, *this->_it); }
+        template<class F, typename Stream>
+        void deserializeElem(F* dez, Stream& is) const 
+        { 
+            T tmp(makeElement<T>(this->_adapter->getContainer().get_allocator()));
+            dez->readStatic(is, tmp);
+            this->_instance.push(std::move(tmp));
+        }
+    };
+
+    /* -- STATICALLY DISPATCHED CLASS -- */
+
+    /** Sentinel after the members of a class given to visitMemberAt **/
+    struct MemberEnd {};
+
+    template<typename V>
+    inline void visitMemberAt(size_t index, const V& visitor, const MemberEnd& end) 
+    {
+        throw OutOfRangeException();
+    }
+
+    /** Calls the visitor with the member at index of the list of members **/
+    template<typename V, typename M, typename... Members>
+    inline void visitMemberAt(size_t index, const V& visitor, const M& member, const Members&... members)
+    {
+        if(index == 0)
+            visitor(member);
+        else
+            visitMemberAt(index - 1, visitor, members...);
+    }
+
+    /** Writes the member visited with the format F **/
+    template<class F, typename Stream>
+    struct MemberWriter
+    {
+        MemberWriter(F* sez, Stream& os, void* instance) : sez(sez), os(os), instance(instance) {}
+
+        template<typename M>
+        void operator()(const M& member) const { M::writeStatic(sez, os, instance); }
+
+        F* sez;
+        Stream& os;
+        void* instance;
     };
 
-    /** Specialization fo a serializable class **/
+    /** Reads the member visited with the format F **/
+    template<class F, typename Stream>
+    struct MemberReader
+    {
+        MemberReader(F* dez, Stream& is, void* instance) : dez(dez), is(is), instance(instance) {}
+
+        template<typename M>
+        void operator()(const M& member) const { M::readStatic(dez, is, instance); }
+
+        F* dez;
+        Stream& is;
+        void* instance;
+    };
+
+    /** Statically dispatched serializable class. The members are visited in the order of the 
+    REGISTER_SERIALIZABLE declaration instead of through the member table functions **/
     template<class C>
-    class SerializableClass : public Serializable
+    class StaticClass final : public SerializableClass<C>
     {
     public:
-        SerializableClass(C& instance) : 
-            Serializable(),
-            _instance(instance) 
+        StaticClass(C& instance) : SerializableClass<C>(instance) {}
+        StaticClass(const C& instance) : SerializableClass<C>(instance) {}
+
+        template<class F, typename Stream>
+        void serializeElemValue(F* sez, Stream& os) const 
         {
+            SerializableClass<C>::visitMember(this->getElemIndex(), MemberWriter<F, Stream>(sez, os, this->_instance));
         }
-
-        SerializableClass(const C& instance) : 
-            Serializable(),
-            _instance(const_cast<C&>(instance)) 
+        template<class F, typename Stream>
+        bool deserializeElemName(F* dez, Stream& is) const
         {
+            // Qualified calls to the implementation are not virtual
+            return ((this->_it = dez->DeserializerImpl<F>::read(is, this->_members)) != 0);
+        }
+        template<class F, typename Stream>
+        void deserializeElemValue(F* dez, Stream& is) const
+        {
+            SerializableClass<C>::visitMember(this->getElemIndex(), MemberReader<F, Stream>(dez, is, this->_instance));
         }
-
-    protected:
-        C& _instance;
     };
 
     /* -- SERIALIZER INTERFACE -- */
     class Serializer
     {
     public:
+        /** Compatibility with std::ostream. Output is buffered by a StreamWriter and flushed at the end **/
+        void write(std::ostream& os)
+        {
+            StreamWriter writer(os);
+            this->write(writer);
+        }
+        template<typename T>
+        void write(std::ostream& os, T&& value)
+        {
+            StreamWriter writer(os);
+            this->write(writer, std::forward<T>(value));
+        }
+        template<typename T>
+        void write(std::ostream& os, const T* vector, const size_t& size)
+        {
+            StreamWriter writer(os);
+            this->write(writer, vector, size);
+        }
         /** Null values **/
-        virtual void write(std::ostream& os) = 0;
+        virtual void write(Writer& os) = 0;
         virtual void write(std::wostream& os) = 0;
         /** Basic types **/
-        virtual void write(std::ostream& os, const bool& value) = 0;
-        virtual void write(std::ostream& os, const char& value) = 0;
-        virtual void write(std::ostream& os, const unsigned char& value) = 0;
-        virtual void write(std::ostream& os, const wchar_t& value) = 0;
-        virtual void write(std::ostream& os, const short& value) = 0;
-        virtual void write(std::ostream& os, const unsigned short& value) = 0;
-        virtual void write(std::ostream& os, const int& value) = 0;
-        virtual void write(std::ostream& os, const unsigned int& value) = 0;
-        virtual void write(std::ostream& os, const long& value) = 0;
-        virtual void write(std::ostream& os, const unsigned long& value) = 0;
-        virtual void write(std::ostream& os, const long long& value) = 0;
-        virtual void write(std::ostream& os, const unsigned long long& value) = 0;
-        virtual void write(std::ostream& os, const float& value) = 0;
-        virtual void write(std::ostream& os, const double& value) = 0;
-        virtual void write(std::ostream& os, const long double& value) = 0;
-        virtual void write(std::ostream& os, bool* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, char* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, unsigned char* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, wchar_t* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, short* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, unsigned short* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, int* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, unsigned int* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, long* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, unsigned long* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, long long* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, unsigned long long* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, float* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, double* value) { this->write(os, *value); }
-        virtual void write(std::ostream& os, long double* value) { this->write(os, *value); }
+        virtual void write(Writer& os, const bool& value) = 0;
+        virtual void write(Writer& os, const char& value) = 0;
+        virtual void write(Writer& os, const unsigned char& value) = 0;
+        virtual void write(Writer& os, const wchar_t& value) = 0;
+        virtual void write(Writer& os, const short& value) = 0;
+        virtual void write(Writer& os, const unsigned short& value) = 0;
+        virtual void write(Writer& os, const int& value) = 0;
+        virtual void write(Writer& os, const unsigned int& value) = 0;
+        virtual void write(Writer& os, const long& value) = 0;
+        virtual void write(Writer& os, const unsigned long& value) = 0;
+        virtual void write(Writer& os, const long long& value) = 0;
+        virtual void write(Writer& os, const unsigned long long& value) = 0;
+        virtual void write(Writer& os, const float& value) = 0;
+        virtual void write(Writer& os, const double& value) = 0;
+        virtual void write(Writer& os, const long double& value) = 0;
+        virtual void write(Writer& os, bool* value) { this->write(os, *value); }
+        virtual void write(Writer& os, char* value) { this->write(os, *value); }
+        virtual void write(Writer& os, unsigned char* value) { this->write(os, *value); }
+        virtual void write(Writer& os, wchar_t* value) { this->write(os, *value); }
+        virtual void write(Writer& os, short* value) { this->write(os, *value); }
+        virtual void write(Writer& os, unsigned short* value) { this->write(os, *value); }
+        virtual void write(Writer& os, int* value) { this->write(os, *value); }
+        virtual void write(Writer& os, unsigned int* value) { this->write(os, *value); }
+        virtual void write(Writer& os, long* value) { this->write(os, *value); }
+        virtual void write(Writer& os, unsigned long* value) { this->write(os, *value); }
+        virtual void write(Writer& os, long long* value) { this->write(os, *value); }
+        virtual void write(Writer& os, unsigned long long* value) { this->write(os, *value); }
+        virtual void write(Writer& os, float* value) { this->write(os, *value); }
+        virtual void write(Writer& os, double* value) { this->write(os, *value); }
+        virtual void write(Writer& os, long double* value) { this->write(os, *value); }
         virtual void write(std::wostream& os, const bool& value) = 0;
         virtual void write(std::wostream& os, const char& value) = 0;
         virtual void write(std::wostream& os, const unsigned char& value) = 0;
@@ -612,21 +1504,21 @@ namespace Seza
         virtual void write(std::wostream& os, double* value) { this->write(os, *value); }
         virtual void write(std::wostream& os, long double* value) { this->write(os, *value); }
         /** Arrays of basic types **/
-        virtual void write(std::ostream& os, const bool* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const char* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const unsigned char* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const wchar_t* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const short* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const unsigned short* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const int* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const unsigned int* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const long* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const unsigned long* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const long long* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const unsigned long long* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const float* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const double* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const long double* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const bool* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const char* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const unsigned char* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const wchar_t* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const short* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const unsigned short* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const int* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const unsigned int* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const long* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const unsigned long* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const long long* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const unsigned long long* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const float* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const double* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const long double* vector, const size_t& size) = 0;
         virtual void write(std::wostream& os, const bool* vector, const size_t& size) = 0;
         virtual void write(std::wostream& os, const char* vector, const size_t& size) = 0;
         virtual void write(std::wostream& os, const unsigned char* vector, const size_t& size) = 0;
@@ -643,229 +1535,248 @@ namespace Seza
         virtual void write(std::wostream& os, const double* vector, const size_t& size) = 0;
         virtual void write(std::wostream& os, const long double* vector, const size_t& size) = 0;
         /** Strings **/
-        virtual void write(std::ostream& os, const std::string& string) = 0;
-        virtual void write(std::ostream& os, const std::wstring& string) = 0;
+        virtual void write(Writer& os, const std::string& string) = 0;
+        virtual void write(Writer& os, const std::wstring& string) = 0;
         virtual void write(std::wostream& os, const std::string& string) = 0;
         virtual void write(std::wostream& os, const std::wstring& string) = 0;
+#if __cplusplus >= 201703L
+        /** Strings allocated in a memory resource **/
+        virtual void write(Writer& os, const std::pmr::string& string) = 0;
+        virtual void write(std::wostream& os, const std::pmr::string& string) = 0;
+        /** String views **/
+        virtual void write(Writer& os, const std::string_view& string) = 0;
+        virtual void write(Writer& os, const std::wstring_view& string) = 0;
+        virtual void write(std::wostream& os, const std::string_view& string) = 0;
+        virtual void write(std::wostream& os, const std::wstring_view& string) = 0;
+#endif
         /** Arrays of strings **/
-        virtual void write(std::ostream& os, const std::string* vector, const size_t& size) = 0;
-        virtual void write(std::ostream& os, const std::wstring* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const std::string* vector, const size_t& size) = 0;
+        virtual void write(Writer& os, const std::wstring* vector, const size_t& size) = 0;
         virtual void write(std::wostream& os, const std::string* vector, const size_t& size) = 0;
         virtual void write(std::wostream& os, const std::wstring* vector, const size_t& size) = 0;
         /** Serializable STL container **/
-        virtual void write(std::ostream& os, const SerializableSTLContainer& container) = 0;
+        virtual void write(Writer& os, const SerializableSTLContainer& container) = 0;
         virtual void write(std::wostream& os, const SerializableSTLContainer& container) = 0;
+        /** Ranges and generators, written as arrays **/
+        template<typename It>
+        void write(Writer& os, const SerializableRange<It>& range) { this->write(os, (const SerializableSTLContainer&) range); }
+        template<typename It>
+        void write(std::wostream& os, const SerializableRange<It>& range) { this->write(os, (const SerializableSTLContainer&) range); }
+        template<typename T, typename G>
+        void write(Writer& os, const SerializableGenerator<T, G>& generator) { this->write(os, (const SerializableSTLContainer&) generator); }
+        template<typename T, typename G>
+        void write(std::wostream& os, const SerializableGenerator<T, G>& generator) { this->write(os, (const SerializableSTLContainer&) generator); }
         /** Automatic serializators for STL containers **/
         template<typename K, typename T>
-        void write(std::ostream& os, std::pair<K, T>& container)
+        void write(Writer& os, const std::pair<K, T>& container)
         {
-            SerializableSTLPair<K, T> tmp(container, "std::pair");
+            SerializableSTLConstPair<K, T> tmp(container);
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
         template<typename T, std::size_t N>
-        void write(std::ostream& os, std::array<T, N>& container)
+        void write(Writer& os, const std::array<T, N>& container)
         {
             SerializableSTLList<std::array<T, N>, T> tmp(const_cast<std::array<T, N>&>(container), "std::array");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::deque<T>& container)
+        template<typename T, typename A>
+        void write(Writer& os, const std::deque<T, A>& container)
         {
-            SerializableSTLList<std::deque<T>, T> tmp(container, "std::deque");
+            SerializableSTLList<std::deque<T, A>, T> tmp(const_cast<std::deque<T, A>&>(container), "std::deque");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::forward_list<T>& container)
+        template<typename T, typename A>
+        void write(Writer& os, const std::forward_list<T, A>& container)
         {
-            SerializableSTLList<std::forward_list<T>, T> tmp(container, "std::forward_list");
+            SerializableSTLList<std::forward_list<T, A>, T> tmp(const_cast<std::forward_list<T, A>&>(container), "std::forward_list");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::list<T>& container)
+        template<typename T, typename A>
+        void write(Writer& os, const std::list<T, A>& container)
         {
-            SerializableSTLList<std::list<T>, T> tmp(container, "std::list");
+            SerializableSTLList<std::list<T, A>, T> tmp(const_cast<std::list<T, A>&>(container), "std::list");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::ostream& os, std::map<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void write(Writer& os, const std::map<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::map<K, T>, K, T> tmp(container, "std::map");
+            SerializableSTLMap<std::map<K, T, P, A>, K, T> tmp(const_cast<std::map<K, T, P, A>&>(container), "std::map");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::ostream& os, std::multimap<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void write(Writer& os, const std::multimap<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::multimap<K, T>, K, T> tmp(container, "std::multimap");
+            SerializableSTLMap<std::multimap<K, T, P, A>, K, T> tmp(const_cast<std::multimap<K, T, P, A>&>(container), "std::multimap");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::multiset<T>& container)
+        template<typename T, typename P, typename A>
+        void write(Writer& os, const std::multiset<T, P, A>& container)
         {
-            SerializableSTLSet<std::multiset<T>, T> tmp(container, "std::multiset");
+            SerializableSTLSet<std::multiset<T, P, A>, T> tmp(const_cast<std::multiset<T, P, A>&>(container), "std::multiset");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::priority_queue<T>& container)
+        template<typename T, typename S, typename P>
+        void write(Writer& os, const std::priority_queue<T, S, P>& container)
         {
-            SerializableSTLQueue<std::priority_queue<T>, T> tmp(container, "std::priority_queue");
+            SerializableSTLQueue<std::priority_queue<T, S, P>, T> tmp(const_cast<std::priority_queue<T, S, P>&>(container), "std::priority_queue");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::queue<T>& container)
+        template<typename T, typename S>
+        void write(Writer& os, const std::queue<T, S>& container)
         {
-            SerializableSTLQueue<std::queue<T>, T> tmp(container, "std::queue");
+            SerializableSTLQueue<std::queue<T, S>, T> tmp(const_cast<std::queue<T, S>&>(container), "std::queue");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::set<T>& container)
+        template<typename T, typename P, typename A>
+        void write(Writer& os, const std::set<T, P, A>& container)
         {
-            SerializableSTLSet<std::set<T>, T> tmp(container, "std::set");
+            SerializableSTLSet<std::set<T, P, A>, T> tmp(const_cast<std::set<T, P, A>&>(container), "std::set");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::stack<T>& container)
+        template<typename T, typename S>
+        void write(Writer& os, const std::stack<T, S>& container)
         {
-            SerializableSTLQueue<std::stack<T>, T> tmp(container, "std::stack");
+            SerializableSTLQueue<std::stack<T, S>, T> tmp(const_cast<std::stack<T, S>&>(container), "std::stack");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::ostream& os, std::unordered_map<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void write(Writer& os, const std::unordered_map<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_map<K, T>, K, T> tmp(container, "std::unordered_map");
+            SerializableSTLMap<std::unordered_map<K, T, H, E, A>, K, T> tmp(const_cast<std::unordered_map<K, T, H, E, A>&>(container), "std::unordered_map");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::ostream& os, std::unordered_multimap<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void write(Writer& os, const std::unordered_multimap<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_multimap<K, T>, K, T> tmp(container, "std::unordered_multimap");
+            SerializableSTLMap<std::unordered_multimap<K, T, H, E, A>, K, T> tmp(const_cast<std::unordered_multimap<K, T, H, E, A>&>(container), "std::unordered_multimap");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::unordered_multiset<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void write(Writer& os, const std::unordered_multiset<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_multiset<T>, T> tmp(container, "std::unordered_multiset");
+            SerializableSTLSet<std::unordered_multiset<T, H, E, A>, T> tmp(const_cast<std::unordered_multiset<T, H, E, A>&>(container), "std::unordered_multiset");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::unordered_set<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void write(Writer& os, const std::unordered_set<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_set<T>, T> tmp(container, "std::unordered_set");
+            SerializableSTLSet<std::unordered_set<T, H, E, A>, T> tmp(const_cast<std::unordered_set<T, H, E, A>&>(container), "std::unordered_set");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::ostream& os, std::vector<T>& container)
+        template<typename T, typename A>
+        void write(Writer& os, const std::vector<T, A>& container)
         {
-            SerializableSTLList<std::vector<T>, T> tmp(container, "std::vector");
+            SerializableSTLList<std::vector<T, A>, T> tmp(const_cast<std::vector<T, A>&>(container), "std::vector");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
         template<typename K, typename T>
-        void write(std::wostream& os, std::pair<K, T>& container)
+        void write(std::wostream& os, const std::pair<K, T>& container)
         {
-            SerializableSTLPair<K, T> tmp(container, "std::pair");
+            SerializableSTLConstPair<K, T> tmp(container);
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
         template<typename T, std::size_t N>
-        void write(std::wostream& os, std::array<T, N>& container)
+        void write(std::wostream& os, const std::array<T, N>& container)
         {
-            SerializableSTLList<std::array<T, N>, T> tmp(container, "std::array");
+            SerializableSTLList<std::array<T, N>, T> tmp(const_cast<std::array<T, N>&>(container), "std::array");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::deque<T>& container)
+        template<typename T, typename A>
+        void write(std::wostream& os, const std::deque<T, A>& container)
         {
-            SerializableSTLList<std::deque<T>, T> tmp(container, "std::deque");
+            SerializableSTLList<std::deque<T, A>, T> tmp(const_cast<std::deque<T, A>&>(container), "std::deque");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::forward_list<T>& container)
+        template<typename T, typename A>
+        void write(std::wostream& os, const std::forward_list<T, A>& container)
         {
-            SerializableSTLList<std::forward_list<T>, T> tmp(container, "std::forward_list");
+            SerializableSTLList<std::forward_list<T, A>, T> tmp(const_cast<std::forward_list<T, A>&>(container), "std::forward_list");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::list<T>& container)
+        template<typename T, typename A>
+        void write(std::wostream& os, const std::list<T, A>& container)
         {
-            SerializableSTLList<std::list<T>, T> tmp(container, "std::list");
+            SerializableSTLList<std::list<T, A>, T> tmp(const_cast<std::list<T, A>&>(container), "std::list");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::wostream& os, std::map<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void write(std::wostream& os, const std::map<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::map<K, T>, K, T> tmp(container, "std::map");
+            SerializableSTLMap<std::map<K, T, P, A>, K, T> tmp(const_cast<std::map<K, T, P, A>&>(container), "std::map");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::wostream& os, std::multimap<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void write(std::wostream& os, const std::multimap<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::multimap<K, T>, K, T> tmp(container, "std::multimap");
+            SerializableSTLMap<std::multimap<K, T, P, A>, K, T> tmp(const_cast<std::multimap<K, T, P, A>&>(container), "std::multimap");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::multiset<T>& container)
+        template<typename T, typename P, typename A>
+        void write(std::wostream& os, const std::multiset<T, P, A>& container)
         {
-            SerializableSTLSet<std::multiset<T>, T> tmp(container, "std::multiset");
+            SerializableSTLSet<std::multiset<T, P, A>, T> tmp(const_cast<std::multiset<T, P, A>&>(container), "std::multiset");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::priority_queue<T>& container)
+        template<typename T, typename S, typename P>
+        void write(std::wostream& os, const std::priority_queue<T, S, P>& container)
         {
-            SerializableSTLQueue<std::priority_queue<T>, T> tmp(container, "std::priority_queue");
+            SerializableSTLQueue<std::priority_queue<T, S, P>, T> tmp(const_cast<std::priority_queue<T, S, P>&>(container), "std::priority_queue");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::queue<T>& container)
+        template<typename T, typename S>
+        void write(std::wostream& os, const std::queue<T, S>& container)
         {
-            SerializableSTLQueue<std::queue<T>, T> tmp(container, "std::queue");
+            SerializableSTLQueue<std::queue<T, S>, T> tmp(const_cast<std::queue<T, S>&>(container), "std::queue");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::set<T>& container)
+        template<typename T, typename P, typename A>
+        void write(std::wostream& os, const std::set<T, P, A>& container)
         {
-            SerializableSTLSet<std::set<T>, T> tmp(container, "std::set");
+            SerializableSTLSet<std::set<T, P, A>, T> tmp(const_cast<std::set<T, P, A>&>(container), "std::set");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::stack<T>& container)
+        template<typename T, typename S>
+        void write(std::wostream& os, const std::stack<T, S>& container)
         {
-            SerializableSTLQueue<std::stack<T>, T> tmp(container, "std::stack");
+            SerializableSTLQueue<std::stack<T, S>, T> tmp(const_cast<std::stack<T, S>&>(container), "std::stack");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::wostream& os, std::unordered_map<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void write(std::wostream& os, const std::unordered_map<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_map<K, T>, K, T> tmp(container, "std::unordered_map");
+            SerializableSTLMap<std::unordered_map<K, T, H, E, A>, K, T> tmp(const_cast<std::unordered_map<K, T, H, E, A>&>(container), "std::unordered_map");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void write(std::wostream& os, std::unordered_multimap<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void write(std::wostream& os, const std::unordered_multimap<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_multimap<K, T>, K, T> tmp(container, "std::unordered_multimap");
+            SerializableSTLMap<std::unordered_multimap<K, T, H, E, A>, K, T> tmp(const_cast<std::unordered_multimap<K, T, H, E, A>&>(container), "std::unordered_multimap");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::unordered_multiset<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void write(std::wostream& os, const std::unordered_multiset<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_multiset<T>, T> tmp(container, "std::unordered_multiset");
+            SerializableSTLSet<std::unordered_multiset<T, H, E, A>, T> tmp(const_cast<std::unordered_multiset<T, H, E, A>&>(container), "std::unordered_multiset");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::unordered_set<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void write(std::wostream& os, const std::unordered_set<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_set<T>, T> tmp(container, "std::unordered_set");
+            SerializableSTLSet<std::unordered_set<T, H, E, A>, T> tmp(const_cast<std::unordered_set<T, H, E, A>&>(container), "std::unordered_set");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void write(std::wostream& os, std::vector<T>& container)
+        template<typename T, typename A>
+        void write(std::wostream& os, const std::vector<T, A>& container)
         {
-            SerializableSTLList<std::vector<T>, T> tmp(container, "std::vector");
+            SerializableSTLList<std::vector<T, A>, T> tmp(const_cast<std::vector<T, A>&>(container), "std::vector");
             this->write(os, (const SerializableSTLContainer&) tmp);
         }
         /** Serializable classes **/
-        virtual void write(std::ostream& os, const Serializable& object) = 0;
+        virtual void write(Writer& os, const Serializable& object) = 0;
         virtual void write(std::wostream& os, const Serializable& object) = 0;
         /** Automatic serializators for serializable classes **/
         template<typename C>
-        void write(std::ostream& os, const C& object, typename std::enable_if<!(std::is_abstract<SerializableClass<C> >::value) >::type* = 0)
+        void write(Writer& os, const C& object, typename std::enable_if<!(std::is_abstract<SerializableClass<C> >::value) >::type* = 0)
         {
             SerializableClass<C> tmp(object);
             this->write(os, (const Serializable&) tmp);
@@ -878,7 +1789,7 @@ namespace Seza
         }
         /** Automatic serializators for non serializable classes **/
         template<typename C>
-        void write(std::ostream& os, const C& object, typename std::enable_if<(!(std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
+        void write(Writer& os, const C& object, typename std::enable_if<(!(std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
         {
             this->write(os);
         }
@@ -889,7 +1800,7 @@ namespace Seza
         }
         /** Automatic serializators for enums. Enums are converted to int **/
         template<typename C>
-        void write(std::ostream& os, const C& object, typename std::enable_if<((std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
+        void write(Writer& os, const C& object, typename std::enable_if<((std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
         {
             this->write(os, (int)object);
         }
@@ -904,40 +1815,59 @@ namespace Seza
     class Deserializer
     {
     public:
+        /** Compatibility with std::istream. Input is read in blocks by a StreamReader and the bytes 
+        not used are given back to the stream at the end **/
+        void read(std::istream& is)
+        {
+            StreamReader reader(is);
+            this->read(reader);
+        }
+        template<typename T>
+        void read(std::istream& is, T&& value)
+        {
+            StreamReader reader(is);
+            this->read(reader, std::forward<T>(value));
+        }
+        template<typename T>
+        size_t read(std::istream& is, T* vector, const size_t& size)
+        {
+            StreamReader reader(is);
+            return this->read(reader, vector, size);
+        }
         /** Null values **/
-        virtual void read(std::istream& is) = 0;
+        virtual void read(Reader& is) = 0;
         virtual void read(std::wistream& is) = 0;
         /** Basic types **/
-        virtual void read(std::istream& is, bool& value) = 0;
-        virtual void read(std::istream& is, char& value) = 0;
-        virtual void read(std::istream& is, unsigned char& value) = 0;
-        virtual void read(std::istream& is, wchar_t& value) = 0;
-        virtual void read(std::istream& is, short& value) = 0;
-        virtual void read(std::istream& is, unsigned short& value) = 0;
-        virtual void read(std::istream& is, int& value) = 0;
-        virtual void read(std::istream& is, unsigned int& value) = 0;
-        virtual void read(std::istream& is, long& value) = 0;
-        virtual void read(std::istream& is, unsigned long& value) = 0;
-        virtual void read(std::istream& is, long long& value) = 0;
-        virtual void read(std::istream& is, unsigned long long& value) = 0;
-        virtual void read(std::istream& is, float& value) = 0;
-        virtual void read(std::istream& is, double& value) = 0;
-        virtual void read(std::istream& is, long double& value) = 0;
-        virtual void read(std::istream& is, bool* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, char* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, unsigned char* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, wchar_t* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, short* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, unsigned short* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, int* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, unsigned int* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, long* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, unsigned long* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, long long* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, unsigned long long* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, float* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, double* value) { this->read(is, *value); }
-        virtual void read(std::istream& is, long double* value) { this->read(is, *value); }
+        virtual void read(Reader& is, bool& value) = 0;
+        virtual void read(Reader& is, char& value) = 0;
+        virtual void read(Reader& is, unsigned char& value) = 0;
+        virtual void read(Reader& is, wchar_t& value) = 0;
+        virtual void read(Reader& is, short& value) = 0;
+        virtual void read(Reader& is, unsigned short& value) = 0;
+        virtual void read(Reader& is, int& value) = 0;
+        virtual void read(Reader& is, unsigned int& value) = 0;
+        virtual void read(Reader& is, long& value) = 0;
+        virtual void read(Reader& is, unsigned long& value) = 0;
+        virtual void read(Reader& is, long long& value) = 0;
+        virtual void read(Reader& is, unsigned long long& value) = 0;
+        virtual void read(Reader& is, float& value) = 0;
+        virtual void read(Reader& is, double& value) = 0;
+        virtual void read(Reader& is, long double& value) = 0;
+        virtual void read(Reader& is, bool* value) { this->read(is, *value); }
+        virtual void read(Reader& is, char* value) { this->read(is, *value); }
+        virtual void read(Reader& is, unsigned char* value) { this->read(is, *value); }
+        virtual void read(Reader& is, wchar_t* value) { this->read(is, *value); }
+        virtual void read(Reader& is, short* value) { this->read(is, *value); }
+        virtual void read(Reader& is, unsigned short* value) { this->read(is, *value); }
+        virtual void read(Reader& is, int* value) { this->read(is, *value); }
+        virtual void read(Reader& is, unsigned int* value) { this->read(is, *value); }
+        virtual void read(Reader& is, long* value) { this->read(is, *value); }
+        virtual void read(Reader& is, unsigned long* value) { this->read(is, *value); }
+        virtual void read(Reader& is, long long* value) { this->read(is, *value); }
+        virtual void read(Reader& is, unsigned long long* value) { this->read(is, *value); }
+        virtual void read(Reader& is, float* value) { this->read(is, *value); }
+        virtual void read(Reader& is, double* value) { this->read(is, *value); }
+        virtual void read(Reader& is, long double* value) { this->read(is, *value); }
         virtual void read(std::wistream& is, bool& value) = 0;
         virtual void read(std::wistream& is, char& value) = 0;
         virtual void read(std::wistream& is, unsigned char& value) = 0;
@@ -969,21 +1899,21 @@ namespace Seza
         virtual void read(std::wistream& is, double* value) { this->read(is, *value); }
         virtual void read(std::wistream& is, long double* value) { this->read(is, *value); }
         /** Arrays of basic types **/
-        virtual size_t read(std::istream& is, bool* value, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, char* value, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, unsigned char* value, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, wchar_t* value, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, short* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, unsigned short* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, int* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, unsigned int* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, long* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, unsigned long* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, long long* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, unsigned long long* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, float* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, double* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, long double* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, bool* value, const size_t& size) = 0;
+        virtual size_t read(Reader& is, char* value, const size_t& size) = 0;
+        virtual size_t read(Reader& is, unsigned char* value, const size_t& size) = 0;
+        virtual size_t read(Reader& is, wchar_t* value, const size_t& size) = 0;
+        virtual size_t read(Reader& is, short* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, unsigned short* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, int* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, unsigned int* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, long* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, unsigned long* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, long long* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, unsigned long long* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, float* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, double* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, long double* vector, const size_t& size) = 0;
         virtual size_t read(std::wistream& is, bool* value, const size_t& size) = 0;
         virtual size_t read(std::wistream& is, char* value, const size_t& size) = 0;
         virtual size_t read(std::wistream& is, unsigned char* value, const size_t& size) = 0;
@@ -1000,120 +1930,133 @@ namespace Seza
         virtual size_t read(std::wistream& is, double* vector, const size_t& size) = 0;
         virtual size_t read(std::wistream& is, long double* vector, const size_t& size) = 0;
         /** Strings **/
-        virtual void read(std::istream& is, std::string& string) = 0;
-        virtual void read(std::istream& is, std::wstring& string) = 0;
+        virtual void read(Reader& is, std::string& string) = 0;
+        virtual void read(Reader& is, std::wstring& string) = 0;
         virtual void read(std::wistream& is, std::string& string) = 0;
         virtual void read(std::wistream& is, std::wstring& string) = 0;
+#if __cplusplus >= 201703L
+        /** Strings allocated in a memory resource **/
+        virtual void read(Reader& is, std::pmr::string& string) = 0;
+        virtual void read(std::wistream& is, std::pmr::string& string) = 0;
+        /** String views. The strings are interned in the string pool of the deserializer **/
+        virtual void read(Reader& is, std::string_view& string) = 0;
+        virtual void read(Reader& is, std::wstring_view& string) = 0;
+        virtual void read(std::wistream& is, std::string_view& string) = 0;
+        virtual void read(std::wistream& is, std::wstring_view& string) = 0;
+#endif
         /** Arrays of strings **/
-        virtual size_t read(std::istream& is, std::string* vector, const size_t& size) = 0;
-        virtual size_t read(std::istream& is, std::wstring* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, std::string* vector, const size_t& size) = 0;
+        virtual size_t read(Reader& is, std::wstring* vector, const size_t& size) = 0;
         virtual size_t read(std::wistream& is, std::string* vector, const size_t& size) = 0;
         virtual size_t read(std::wistream& is, std::wstring* vector, const size_t& size) = 0;
+        /** Member names. Returns the member of the table with the name read or null if it does not exist **/
+        virtual const MemberDescriptor* read(Reader& is, const MemberTable& members) = 0;
+        virtual const MemberDescriptor* read(std::wistream& is, const MemberTable& members) = 0;
         /** Serializable STL container **/
-        virtual void read(std::istream& is, SerializableSTLContainer& container) = 0;
+        virtual void read(Reader& is, SerializableSTLContainer& container) = 0;
         virtual void read(std::wistream& is, SerializableSTLContainer& container) = 0;
         /** Automatic serializators for STL containers **/
         template<typename K, typename T>
-        void read(std::istream& is, std::pair<K, T>& container)
+        void read(Reader& is, std::pair<K, T>& container)
         {
             SerializableSTLPair<K, T> tmp(container, "std::pair");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
         template<typename T, std::size_t N>
-        void read(std::istream& is, std::array<T, N>& container)
+        void read(Reader& is, std::array<T, N>& container)
         {
             SerializableSTLList<std::array<T, N>, T> tmp(container, "std::array");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::deque<T>& container)
+        template<typename T, typename A>
+        void read(Reader& is, std::deque<T, A>& container)
         {
-            SerializableSTLList<std::deque<T>, T> tmp(container, "std::deque");
+            SerializableSTLList<std::deque<T, A>, T> tmp(container, "std::deque");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::forward_list<T>& container)
+        template<typename T, typename A>
+        void read(Reader& is, std::forward_list<T, A>& container)
         {
-            SerializableSTLList<std::forward_list<T>, T> tmp(container, "std::forward_list");
+            SerializableSTLList<std::forward_list<T, A>, T> tmp(container, "std::forward_list");
             this->read(is, (SerializableSTLContainer&) tmp);
             container.reverse(); // Trick because the forward list only has push_front
         }
-        template<typename T>
-        void read(std::istream& is, std::list<T>& container)
+        template<typename T, typename A>
+        void read(Reader& is, std::list<T, A>& container)
         {
-            SerializableSTLList<std::list<T>, T> tmp(container, "std::list");
+            SerializableSTLList<std::list<T, A>, T> tmp(container, "std::list");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::istream& is, std::map<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void read(Reader& is, std::map<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::map<K, T>, K, T> tmp(container, "std::map");
+            SerializableSTLMap<std::map<K, T, P, A>, K, T> tmp(container, "std::map");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::istream& is, std::multimap<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void read(Reader& is, std::multimap<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::multimap<K, T>, K, T> tmp(container, "std::multimap");
+            SerializableSTLMap<std::multimap<K, T, P, A>, K, T> tmp(container, "std::multimap");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::multiset<T>& container)
+        template<typename T, typename P, typename A>
+        void read(Reader& is, std::multiset<T, P, A>& container)
         {
-            SerializableSTLSet<std::multiset<T>, T> tmp(container, "std::multiset");
+            SerializableSTLSet<std::multiset<T, P, A>, T> tmp(container, "std::multiset");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::priority_queue<T>& container)
+        template<typename T, typename S, typename P>
+        void read(Reader& is, std::priority_queue<T, S, P>& container)
         {
-            SerializableSTLQueue<std::priority_queue<T>, T> tmp(container, "std::priority_queue");
+            SerializableSTLQueue<std::priority_queue<T, S, P>, T> tmp(container, "std::priority_queue");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::queue<T>& container)
+        template<typename T, typename S>
+        void read(Reader& is, std::queue<T, S>& container)
         {
-            SerializableSTLQueue<std::queue<T>, T> tmp(container, "std::queue");
+            SerializableSTLQueue<std::queue<T, S>, T> tmp(container, "std::queue");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::set<T>& container)
+        template<typename T, typename P, typename A>
+        void read(Reader& is, std::set<T, P, A>& container)
         {
-            SerializableSTLSet<std::set<T>, T> tmp(container, "std::set");
+            SerializableSTLSet<std::set<T, P, A>, T> tmp(container, "std::set");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::stack<T>& container)
+        template<typename T, typename S>
+        void read(Reader& is, std::stack<T, S>& container)
         {
-            SerializableSTLQueue<std::stack<T>, T> tmp(container, "std::stack");
+            SerializableSTLQueue<std::stack<T, S>, T> tmp(container, "std::stack");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::istream& is, std::unordered_map<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void read(Reader& is, std::unordered_map<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_map<K, T>, K, T> tmp(container, "std::unordered_map");
+            SerializableSTLMap<std::unordered_map<K, T, H, E, A>, K, T> tmp(container, "std::unordered_map");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::istream& is, std::unordered_multimap<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void read(Reader& is, std::unordered_multimap<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_multimap<K, T>, K, T> tmp(container, "std::unordered_multimap");
+            SerializableSTLMap<std::unordered_multimap<K, T, H, E, A>, K, T> tmp(container, "std::unordered_multimap");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::unordered_multiset<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void read(Reader& is, std::unordered_multiset<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_multiset<T>, T> tmp(container, "std::unordered_multiset");
+            SerializableSTLSet<std::unordered_multiset<T, H, E, A>, T> tmp(container, "std::unordered_multiset");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::unordered_set<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void read(Reader& is, std::unordered_set<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_set<T>, T> tmp(container, "std::unordered_set");
+            SerializableSTLSet<std::unordered_set<T, H, E, A>, T> tmp(container, "std::unordered_set");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::istream& is, std::vector<T>& container)
+        template<typename T, typename A>
+        void read(Reader& is, std::vector<T, A>& container)
         {
-            SerializableSTLList<std::vector<T>, T> tmp(container, "std::vector");
+            SerializableSTLList<std::vector<T, A>, T> tmp(container, "std::vector");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
         template<typename K, typename T>
@@ -1128,103 +2071,103 @@ namespace Seza
             SerializableSTLList<std::array<T, N>, T> tmp(container, "std::array");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::deque<T>& container)
+        template<typename T, typename A>
+        void read(std::wistream& is, std::deque<T, A>& container)
         {
-            SerializableSTLList<std::deque<T>, T> tmp(container, "std::deque");
+            SerializableSTLList<std::deque<T, A>, T> tmp(container, "std::deque");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::forward_list<T>& container)
+        template<typename T, typename A>
+        void read(std::wistream& is, std::forward_list<T, A>& container)
         {
-            SerializableSTLList<std::forward_list<T>, T> tmp(container, "std::forward_list");
+            SerializableSTLList<std::forward_list<T, A>, T> tmp(container, "std::forward_list");
             this->read(is, (SerializableSTLContainer&) tmp);
             container.reverse(); // Trick because the forward list only has push_front
         }
-        template<typename T>
-        void read(std::wistream& is, std::list<T>& container)
+        template<typename T, typename A>
+        void read(std::wistream& is, std::list<T, A>& container)
         {
-            SerializableSTLList<std::list<T>, T> tmp(container, "std::list");
+            SerializableSTLList<std::list<T, A>, T> tmp(container, "std::list");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::wistream& is, std::map<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void read(std::wistream& is, std::map<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::map<K, T>, K, T> tmp(container, "std::map");
+            SerializableSTLMap<std::map<K, T, P, A>, K, T> tmp(container, "std::map");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::wistream& is, std::multimap<K, T>& container)
+        template<typename K, typename T, typename P, typename A>
+        void read(std::wistream& is, std::multimap<K, T, P, A>& container)
         {
-            SerializableSTLMap<std::multimap<K, T>, K, T> tmp(container, "std::multimap");
+            SerializableSTLMap<std::multimap<K, T, P, A>, K, T> tmp(container, "std::multimap");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::multiset<T>& container)
+        template<typename T, typename P, typename A>
+        void read(std::wistream& is, std::multiset<T, P, A>& container)
         {
-            SerializableSTLSet<std::multiset<T>, T> tmp(container, "std::multiset");
+            SerializableSTLSet<std::multiset<T, P, A>, T> tmp(container, "std::multiset");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::priority_queue<T>& container)
+        template<typename T, typename S, typename P>
+        void read(std::wistream& is, std::priority_queue<T, S, P>& container)
         {
-            SerializableSTLQueue<std::priority_queue<T>, T> tmp(container, "std::priority_queue");
+            SerializableSTLQueue<std::priority_queue<T, S, P>, T> tmp(container, "std::priority_queue");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::queue<T>& container)
+        template<typename T, typename S>
+        void read(std::wistream& is, std::queue<T, S>& container)
         {
-            SerializableSTLQueue<std::queue<T>, T> tmp(container, "std::queue");
+            SerializableSTLQueue<std::queue<T, S>, T> tmp(container, "std::queue");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::set<T>& container)
+        template<typename T, typename P, typename A>
+        void read(std::wistream& is, std::set<T, P, A>& container)
         {
-            SerializableSTLSet<std::set<T>, T> tmp(container, "std::set");
+            SerializableSTLSet<std::set<T, P, A>, T> tmp(container, "std::set");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::stack<T>& container)
+        template<typename T, typename S>
+        void read(std::wistream& is, std::stack<T, S>& container)
         {
-            SerializableSTLQueue<std::stack<T>, T> tmp(container, "std::stack");
+            SerializableSTLQueue<std::stack<T, S>, T> tmp(container, "std::stack");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::wistream& is, std::unordered_map<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void read(std::wistream& is, std::unordered_map<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_map<K, T>, K, T> tmp(container, "std::unordered_map");
+            SerializableSTLMap<std::unordered_map<K, T, H, E, A>, K, T> tmp(container, "std::unordered_map");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename K, typename T>
-        void read(std::wistream& is, std::unordered_multimap<K, T>& container)
+        template<typename K, typename T, typename H, typename E, typename A>
+        void read(std::wistream& is, std::unordered_multimap<K, T, H, E, A>& container)
         {
-            SerializableSTLMap<std::unordered_multimap<K, T>, K, T> tmp(container, "std::unordered_multimap");
+            SerializableSTLMap<std::unordered_multimap<K, T, H, E, A>, K, T> tmp(container, "std::unordered_multimap");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::unordered_multiset<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void read(std::wistream& is, std::unordered_multiset<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_multiset<T>, T> tmp(container, "std::unordered_multiset");
+            SerializableSTLSet<std::unordered_multiset<T, H, E, A>, T> tmp(container, "std::unordered_multiset");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::unordered_set<T>& container)
+        template<typename T, typename H, typename E, typename A>
+        void read(std::wistream& is, std::unordered_set<T, H, E, A>& container)
         {
-            SerializableSTLSet<std::unordered_set<T>, T> tmp(container, "std::unordered_set");
+            SerializableSTLSet<std::unordered_set<T, H, E, A>, T> tmp(container, "std::unordered_set");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
-        template<typename T>
-        void read(std::wistream& is, std::vector<T>& container)
+        template<typename T, typename A>
+        void read(std::wistream& is, std::vector<T, A>& container)
         {
-            SerializableSTLList<std::vector<T>, T> tmp(container, "std::vector");
+            SerializableSTLList<std::vector<T, A>, T> tmp(container, "std::vector");
             this->read(is, (SerializableSTLContainer&) tmp);
         }
         /** Serializable classes **/
-        virtual void read(std::istream& is, Serializable& object) = 0;
+        virtual void read(Reader& is, Serializable& object) = 0;
         virtual void read(std::wistream& is, Serializable& object) = 0;
         /** Automatic serializators for serializable classes **/
         template<typename C>
-        void read(std::istream& is, C& object, typename std::enable_if<!(std::is_abstract<SerializableClass<C> >::value) >::type* = 0)
+        void read(Reader& is, C& object, typename std::enable_if<!(std::is_abstract<SerializableClass<C> >::value) >::type* = 0)
         {
             SerializableClass<C> tmp(object);
             this->read(is, (Serializable&) tmp);
@@ -1237,7 +2180,7 @@ namespace Seza
         }
         /** Automatic serializators for non serializable classes **/
         template<typename C>
-        void read(std::istream& is, C& object, typename std::enable_if<(!(std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
+        void read(Reader& is, C& object, typename std::enable_if<(!(std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
         {
             this->read(is);
         }
@@ -1248,7 +2191,7 @@ namespace Seza
         }
         /** Automatic serializators for enums. Enums are converted to int **/
         template<typename C>
-        void read(std::istream& is, C& object, typename std::enable_if<((std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
+        void read(Reader& is, C& object, typename std::enable_if<((std::is_enum<C>::value)&&(std::is_abstract<SerializableClass<C> >::value)) >::type* = 0)
         {
             int tmp;
             this->read(is, tmp);
@@ -1261,6 +2204,49 @@ namespace Seza
             this->read(is, tmp);
             object = static_cast<C>(tmp);
         }
+        /** Lowest address of the stack that the reading of nested values may reach. Input nested 
+        deeper throws a StackLimitException instead of overflowing the stack. There is no limit by default **/
+        void setStackLimit(const void* limit) { _stackLimit = (uintptr_t)limit; }
+        const void* getStackLimit() const { return (const void*)_stackLimit; }
+#if __cplusplus >= 201703L
+        /** Memory resource of the values created by make. The default resource is used if none is set **/
+        void setMemoryResource(std::pmr::memory_resource* resource) { _resource = resource; }
+        std::pmr::memory_resource* getMemoryResource() const { return _resource ? _resource : std::pmr::get_default_resource(); }
+        /** Pool where the string views read are interned. The views are valid while the pool lives **/
+        void setStringPool(StringPool* pool) { _pool = pool; }
+        StringPool* getStringPool() const { return _pool; }
+        /** Deserializes a new value. A pmr-aware value is created in the memory resource, and all its 
+        strings, containers and elements are allocated in it too **/
+        template<typename T>
+        T make(Reader& is)
+        {
+            T value(makeElement<T>(std::pmr::polymorphic_allocator<char>(getMemoryResource())));
+            this->read(is, value);
+            return value;
+        }
+        template<typename T>
+        T make(std::istream& is)
+        {
+            StreamReader reader(is);
+            return make<T>(reader);
+        }
+#endif
+
+    protected:
+        /** Called by the formats before reading the contents of a container or a class. The stack 
+        grows down on the platforms with a stack limit **/
+        void checkStack() const
+        {
+            char top;
+            if((uintptr_t)&top < _stackLimit)
+                throw StackLimitException();
+        }
+
+        uintptr_t _stackLimit = 0;
+#if __cplusplus >= 201703L
+        std::pmr::memory_resource* _resource = nullptr;
+        StringPool* _pool = nullptr;
+#endif
     };
 
     /* -- SERIALIZER IMPLEMENTATION -- */
@@ -1268,25 +2254,27 @@ namespace Seza
     class SerializerImpl : public Serializer
     {
     public:
+        using Serializer::write;
+
         /** Null values **/
-        virtual void write(std::ostream& os) { static_cast<C*>(this)->writeNull(os); }
+        virtual void write(Writer& os) { static_cast<C*>(this)->writeNull(os); }
         virtual void write(std::wostream& os) { static_cast<C*>(this)->writeNull(os); }
         /** Basic types **/
-        virtual void write(std::ostream& os, const bool& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const char& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const unsigned char& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const wchar_t& value) { static_cast<C*>(this)->writeValue(os, convertToChar(value)); }
-        virtual void write(std::ostream& os, const short& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const unsigned short& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const int& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const unsigned int& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const long& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const unsigned long& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const long long& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const unsigned long long& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const float& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const double& value) { static_cast<C*>(this)->writeValue(os, value); }
-        virtual void write(std::ostream& os, const long double& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const bool& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const char& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const unsigned char& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const wchar_t& value) { static_cast<C*>(this)->writeValue(os, convertToChar(value)); }
+        virtual void write(Writer& os, const short& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const unsigned short& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const int& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const unsigned int& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const long& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const unsigned long& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const long long& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const unsigned long long& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const float& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const double& value) { static_cast<C*>(this)->writeValue(os, value); }
+        virtual void write(Writer& os, const long double& value) { static_cast<C*>(this)->writeValue(os, value); }
         virtual void write(std::wostream& os, const bool& value) { static_cast<C*>(this)->writeValue(os, value); }
         virtual void write(std::wostream& os, const char& value) { static_cast<C*>(this)->writeValue(os, convertToWChar(value)); }
         virtual void write(std::wostream& os, const unsigned char& value) { static_cast<C*>(this)->writeValue(os, convertToWChar((char)value)); }
@@ -1303,21 +2291,21 @@ namespace Seza
         virtual void write(std::wostream& os, const double& value) { static_cast<C*>(this)->writeValue(os, value); }
         virtual void write(std::wostream& os, const long double& value) { static_cast<C*>(this)->writeValue(os, value); }
         /** Arrays of basic types **/
-        virtual void write(std::ostream& os, const bool* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const char* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const unsigned char* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const wchar_t* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const short* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const unsigned short* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const int* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const unsigned int* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const unsigned long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const long long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const unsigned long long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const float* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const double* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const long double* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const bool* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const char* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const unsigned char* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const wchar_t* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const short* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const unsigned short* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const int* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const unsigned int* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const unsigned long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const long long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const unsigned long long* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const float* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const double* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const long double* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         virtual void write(std::wostream& os, const bool* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         virtual void write(std::wostream& os, const char* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         virtual void write(std::wostream& os, const unsigned char* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
@@ -1334,21 +2322,183 @@ namespace Seza
         virtual void write(std::wostream& os, const double* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         virtual void write(std::wostream& os, const long double* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         /** Strings **/
-        virtual void write(std::ostream& os, const std::string& string) { static_cast<C*>(this)->writeString(os, string); }
-        virtual void write(std::ostream& os, const std::wstring& string) { static_cast<C*>(this)->writeString(os, convertToString(string)); }
+        virtual void write(Writer& os, const std::string& string) { static_cast<C*>(this)->writeString(os, string); }
+        virtual void write(Writer& os, const std::wstring& string) { static_cast<C*>(this)->writeString(os, string); }
         virtual void write(std::wostream& os, const std::string& string) { static_cast<C*>(this)->writeString(os, convertToWString(string)); }
         virtual void write(std::wostream& os, const std::wstring& string) { static_cast<C*>(this)->writeString(os, string); }
+#if __cplusplus >= 201703L
+        virtual void write(Writer& os, const std::pmr::string& string) { static_cast<C*>(this)->writeString(os, string); }
+        virtual void write(std::wostream& os, const std::pmr::string& string) { static_cast<C*>(this)->writeString(os, std::wstring(string.begin(), string.end())); }
+        virtual void write(Writer& os, const std::string_view& string) { static_cast<C*>(this)->writeString(os, string); }
+        virtual void write(Writer& os, const std::wstring_view& string) { static_cast<C*>(this)->writeString(os, std::wstring(string)); }
+        virtual void write(std::wostream& os, const std::string_view& string) { static_cast<C*>(this)->writeString(os, std::wstring(string.begin(), string.end())); }
+        virtual void write(std::wostream& os, const std::wstring_view& string) { static_cast<C*>(this)->writeString(os, string); }
+#endif
         /** Arrays of strings **/
-        virtual void write(std::ostream& os, const std::string* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
-        virtual void write(std::ostream& os, const std::wstring* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const std::string* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
+        virtual void write(Writer& os, const std::wstring* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         virtual void write(std::wostream& os, const std::string* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         virtual void write(std::wostream& os, const std::wstring* vector, const size_t& size) { static_cast<C*>(this)->writeArray(os, vector, size); }
         /** Serializable STL container **/
-        virtual void write(std::ostream& os, const SerializableSTLContainer& container) { static_cast<C*>(this)->writeSTLContainer(os, container); }
+        virtual void write(Writer& os, const SerializableSTLContainer& container) { static_cast<C*>(this)->writeSTLContainer(os, container); }
         virtual void write(std::wostream& os, const SerializableSTLContainer& container) { static_cast<C*>(this)->writeSTLContainer(os, container); }
         /** Serializable classes **/
-        virtual void write(std::ostream& os, const Serializable& object) { static_cast<C*>(this)->writeSerializable(os, object); }
+        virtual void write(Writer& os, const Serializable& object) { static_cast<C*>(this)->writeSerializable(os, object); }
         virtual void write(std::wostream& os, const Serializable& object) { static_cast<C*>(this)->writeSerializable(os, object); }
+
+        /* -- STATIC DISPATCH -- */
+
+        /** Statically dispatched serialization used by Seza::serialize. The hooks of the format are
+        called directly, and containers and classes are given to them as final adaptors **/
+        /** Basic types and strings. Qualified calls to this implementation are not virtual **/
+        template<typename Stream, typename T>
+        void writeStatic(Stream& os, const T& value, typename std::enable_if<std::is_arithmetic<T>::value>::type* = 0) { SerializerImpl<C>::write(os, value); }
+        template<typename Stream>
+        void writeStatic(Stream& os, const std::string& string) { SerializerImpl<C>::write(os, string); }
+        template<typename Stream>
+        void writeStatic(Stream& os, const std::wstring& string) { SerializerImpl<C>::write(os, string); }
+#if __cplusplus >= 201703L
+        template<typename Stream>
+        void writeStatic(Stream& os, const std::pmr::string& string) { SerializerImpl<C>::write(os, string); }
+        template<typename Stream>
+        void writeStatic(Stream& os, const std::string_view& string) { SerializerImpl<C>::write(os, string); }
+        template<typename Stream>
+        void writeStatic(Stream& os, const std::wstring_view& string) { SerializerImpl<C>::write(os, string); }
+#endif
+        /** Ranges and generators **/
+        template<typename Stream, typename It>
+        void writeStatic(Stream& os, const SerializableRange<It>& range) { static_cast<C*>(this)->writeSTLContainer(os, range); }
+        template<typename Stream, typename T, typename G>
+        void writeStatic(Stream& os, const SerializableGenerator<T, G>& generator) { static_cast<C*>(this)->writeSTLContainer(os, generator); }
+        /** STL containers **/
+        template<typename Stream, typename K, typename T>
+        void writeStatic(Stream& os, const std::pair<K, T>& container)
+        {
+            SerializableSTLConstPair<K, T> tmp(container);
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, std::size_t N>
+        void writeStatic(Stream& os, const std::array<T, N>& container)
+        {
+            StaticSTLList<std::array<T, N>, T> tmp(const_cast<std::array<T, N>&>(container), "std::array");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename A>
+        void writeStatic(Stream& os, const std::deque<T, A>& container)
+        {
+            StaticSTLList<std::deque<T, A>, T> tmp(const_cast<std::deque<T, A>&>(container), "std::deque");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename A>
+        void writeStatic(Stream& os, const std::forward_list<T, A>& container)
+        {
+            StaticSTLList<std::forward_list<T, A>, T> tmp(const_cast<std::forward_list<T, A>&>(container), "std::forward_list");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename A>
+        void writeStatic(Stream& os, const std::list<T, A>& container)
+        {
+            StaticSTLList<std::list<T, A>, T> tmp(const_cast<std::list<T, A>&>(container), "std::list");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename P, typename A>
+        void writeStatic(Stream& os, const std::map<K, T, P, A>& container)
+        {
+            StaticSTLMap<std::map<K, T, P, A>, K, T> tmp(const_cast<std::map<K, T, P, A>&>(container), "std::map");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename P, typename A>
+        void writeStatic(Stream& os, const std::multimap<K, T, P, A>& container)
+        {
+            StaticSTLMap<std::multimap<K, T, P, A>, K, T> tmp(const_cast<std::multimap<K, T, P, A>&>(container), "std::multimap");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename P, typename A>
+        void writeStatic(Stream& os, const std::multiset<T, P, A>& container)
+        {
+            StaticSTLSet<std::multiset<T, P, A>, T> tmp(const_cast<std::multiset<T, P, A>&>(container), "std::multiset");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename S, typename P>
+        void writeStatic(Stream& os, const std::priority_queue<T, S, P>& container)
+        {
+            StaticSTLQueue<std::priority_queue<T, S, P>, T> tmp(const_cast<std::priority_queue<T, S, P>&>(container), "std::priority_queue");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename S>
+        void writeStatic(Stream& os, const std::queue<T, S>& container)
+        {
+            StaticSTLQueue<std::queue<T, S>, T> tmp(const_cast<std::queue<T, S>&>(container), "std::queue");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename P, typename A>
+        void writeStatic(Stream& os, const std::set<T, P, A>& container)
+        {
+            StaticSTLSet<std::set<T, P, A>, T> tmp(const_cast<std::set<T, P, A>&>(container), "std::set");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename S>
+        void writeStatic(Stream& os, const std::stack<T, S>& container)
+        {
+            StaticSTLQueue<std::stack<T, S>, T> tmp(const_cast<std::stack<T, S>&>(container), "std::stack");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename H, typename E, typename A>
+        void writeStatic(Stream& os, const std::unordered_map<K, T, H, E, A>& container)
+        {
+            StaticSTLMap<std::unordered_map<K, T, H, E, A>, K, T> tmp(const_cast<std::unordered_map<K, T, H, E, A>&>(container), "std::unordered_map");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename H, typename E, typename A>
+        void writeStatic(Stream& os, const std::unordered_multimap<K, T, H, E, A>& container)
+        {
+            StaticSTLMap<std::unordered_multimap<K, T, H, E, A>, K, T> tmp(const_cast<std::unordered_multimap<K, T, H, E, A>&>(container), "std::unordered_multimap");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename H, typename E, typename A>
+        void writeStatic(Stream& os, const std::unordered_multiset<T, H, E, A>& container)
+        {
+            StaticSTLSet<std::unordered_multiset<T, H, E, A>, T> tmp(const_cast<std::unordered_multiset<T, H, E, A>&>(container), "std::unordered_multiset");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename H, typename E, typename A>
+        void writeStatic(Stream& os, const std::unordered_set<T, H, E, A>& container)
+        {
+            StaticSTLSet<std::unordered_set<T, H, E, A>, T> tmp(const_cast<std::unordered_set<T, H, E, A>&>(container), "std::unordered_set");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        template<typename Stream, typename T, typename A>
+        void writeStatic(Stream& os, const std::vector<T, A>& container)
+        {
+            StaticSTLList<std::vector<T, A>, T> tmp(const_cast<std::vector<T, A>&>(container), "std::vector");
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        /** Vectors whose elements are encoded with a number codec **/
+        template<typename Stream, typename T>
+        void writeStatic(Stream& os, const T& container, NumberCodec codec)
+        {
+            StaticSTLList<T, typename T::value_type> tmp(const_cast<T&>(container), "std::vector", codec);
+            static_cast<C*>(this)->writeSTLContainer(os, tmp);
+        }
+        /** Serializable classes **/
+        template<typename Stream, typename T>
+        void writeStatic(Stream& os, const T& object, typename std::enable_if<!(std::is_abstract<SerializableClass<T> >::value) >::type* = 0)
+        {
+            StaticClass<T> tmp(object);
+            static_cast<C*>(this)->writeSerializable(os, tmp);
+        }
+        /** Non serializable classes are null **/
+        template<typename Stream, typename T>
+        void writeStatic(Stream& os, const T& object, typename std::enable_if<(!(std::is_arithmetic<T>::value)&&!(std::is_enum<T>::value)&&(std::is_abstract<SerializableClass<T> >::value)) >::type* = 0)
+        {
+            static_cast<C*>(this)->writeNull(os);
+        }
+        /** Enums are converted to int **/
+        template<typename Stream, typename T>
+        void writeStatic(Stream& os, const T& object, typename std::enable_if<((std::is_enum<T>::value)&&(std::is_abstract<SerializableClass<T> >::value)) >::type* = 0)
+        {
+            SerializerImpl<C>::write(os, (int)object);
+        }
     };
 
     /* -- DESERIALIZER IMPLEMENTATION -- */
@@ -1356,30 +2506,32 @@ namespace Seza
     class DeserializerImpl : public Deserializer
     {
     public:
+        using Deserializer::read;
+
         /** Null values **/
-        virtual void read(std::istream& is) { static_cast<C*>(this)->readNull(is); }
+        virtual void read(Reader& is) { static_cast<C*>(this)->readNull(is); }
         virtual void read(std::wistream& is) { static_cast<C*>(this)->readNull(is); }
         /** Basic types **/
-        virtual void read(std::istream& is, bool& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, char& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, unsigned char& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, wchar_t& value) 
+        virtual void read(Reader& is, bool& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, char& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, unsigned char& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, wchar_t& value) 
         {
             char tmp;
             static_cast<C*>(this)->readValue(is, tmp); 
             value = convertToWChar(tmp);
         }
-        virtual void read(std::istream& is, short& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, unsigned short& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, int& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, unsigned int& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, long& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, unsigned long& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, long long& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, unsigned long long& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, float& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, double& value) { static_cast<C*>(this)->readValue(is, value); }
-        virtual void read(std::istream& is, long double& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, short& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, unsigned short& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, int& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, unsigned int& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, long& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, unsigned long& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, long long& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, unsigned long long& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, float& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, double& value) { static_cast<C*>(this)->readValue(is, value); }
+        virtual void read(Reader& is, long double& value) { static_cast<C*>(this)->readValue(is, value); }
         virtual void read(std::wistream& is, bool& value) { static_cast<C*>(this)->readValue(is, value); }
         virtual void read(std::wistream& is, char& value) 
         {
@@ -1406,21 +2558,21 @@ namespace Seza
         virtual void read(std::wistream& is, double& value) { static_cast<C*>(this)->readValue(is, value); }
         virtual void read(std::wistream& is, long double& value) { static_cast<C*>(this)->readValue(is, value); }
         /** Arrays of basic types **/
-        virtual size_t read(std::istream& is, bool* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, char* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, unsigned char* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, wchar_t* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, short* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, unsigned short* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, int* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, unsigned int* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, unsigned long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, long long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, unsigned long long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, float* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, double* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, long double* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, bool* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, char* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, unsigned char* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, wchar_t* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, short* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, unsigned short* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, int* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, unsigned int* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, unsigned long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, long long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, unsigned long long* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, float* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, double* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, long double* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
         virtual size_t read(std::wistream& is, bool* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
         virtual size_t read(std::wistream& is, char* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
         virtual size_t read(std::wistream& is, unsigned char* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
@@ -1437,13 +2589,8 @@ namespace Seza
         virtual size_t read(std::wistream& is, double* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
         virtual size_t read(std::wistream& is, long double* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
         /** Strings **/
-        virtual void read(std::istream& is, std::string& string) { static_cast<C*>(this)->readString(is, string); }
-        virtual void read(std::istream& is, std::wstring& string)
-        { 
-            std::string tmp;
-            static_cast<C*>(this)->readString(is, tmp);
-            string = convertToWString(tmp);
-        }
+        virtual void read(Reader& is, std::string& string) { static_cast<C*>(this)->readString(is, string); }
+        virtual void read(Reader& is, std::wstring& string) { static_cast<C*>(this)->readString(is, string); }
         virtual void read(std::wistream& is, std::string& string)
         { 
             std::wstring tmp;
@@ -1451,19 +2598,283 @@ namespace Seza
             string = convertToString(tmp);
         }
         virtual void read(std::wistream& is, std::wstring& string) { static_cast<C*>(this)->readString(is, string); }
+#if __cplusplus >= 201703L
+        virtual void read(Reader& is, std::pmr::string& string) { static_cast<C*>(this)->readString(is, string); }
+        virtual void read(std::wistream& is, std::pmr::string& string)
+        { 
+            std::wstring tmp;
+            static_cast<C*>(this)->readString(is, tmp); 
+            string.assign(tmp.begin(), tmp.end());
+        }
+        /** The values are read into scratch strings reused by every view, so strings already 
+        interned are not allocated again **/
+        virtual void read(Reader& is, std::string_view& string) 
+        { 
+            StringPool& pool = stringPool();
+            static_cast<C*>(this)->readString(is, _string);
+            string = pool.intern(_string);
+        }
+        virtual void read(Reader& is, std::wstring_view& string) 
+        { 
+            StringPool& pool = stringPool();
+            static_cast<C*>(this)->readString(is, _wstring);
+            string = pool.intern(_wstring);
+        }
+        virtual void read(std::wistream& is, std::string_view& string) 
+        { 
+            StringPool& pool = stringPool();
+            static_cast<C*>(this)->readString(is, _wstring);
+            _string.assign(_wstring.begin(), _wstring.end());
+            string = pool.intern(_string);
+        }
+        virtual void read(std::wistream& is, std::wstring_view& string) 
+        { 
+            StringPool& pool = stringPool();
+            static_cast<C*>(this)->readString(is, _wstring);
+            string = pool.intern(_wstring);
+        }
+#endif
         /** Arrays of strings **/
-        virtual size_t read(std::istream& is, std::string* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
-        virtual size_t read(std::istream& is, std::wstring* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, std::string* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        virtual size_t read(Reader& is, std::wstring* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
         virtual size_t read(std::wistream& is, std::string* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
         virtual size_t read(std::wistream& is, std::wstring* vector, const size_t& size) { return static_cast<C*>(this)->readArray(is, vector, size); }
+        /** Member names **/
+        virtual const MemberDescriptor* read(Reader& is, const MemberTable& members) { return static_cast<C*>(this)->readName(is, members); }
+        virtual const MemberDescriptor* read(std::wistream& is, const MemberTable& members) { return static_cast<C*>(this)->readName(is, members); }
         /** Serializable STL container **/
-        virtual void read(std::istream& is, SerializableSTLContainer& container) { return static_cast<C*>(this)->readSTLContainer(is, container); }
+        virtual void read(Reader& is, SerializableSTLContainer& container) { return static_cast<C*>(this)->readSTLContainer(is, container); }
         virtual void read(std::wistream& is, SerializableSTLContainer& container) { return static_cast<C*>(this)->readSTLContainer(is, container); }
         /** Serializable classes **/
-        virtual void read(std::istream& is, Serializable& object) { static_cast<C*>(this)->readSerializable(is, object); }
+        virtual void read(Reader& is, Serializable& object) { static_cast<C*>(this)->readSerializable(is, object); }
         virtual void read(std::wistream& is, Serializable& object) { static_cast<C*>(this)->readSerializable(is, object); }
+
+        /* -- STATIC DISPATCH -- */
+
+        /** Statically dispatched deserialization used by Seza::deserialize. The hooks of the format are
+        called directly, and containers and classes are given to them as final adaptors **/
+        /** Basic types and strings. Qualified calls to this implementation are not virtual **/
+        template<typename Stream, typename T>
+        void readStatic(Stream& is, T& value, typename std::enable_if<std::is_arithmetic<T>::value>::type* = 0) { DeserializerImpl<C>::read(is, value); }
+        template<typename Stream>
+        void readStatic(Stream& is, std::string& string) { DeserializerImpl<C>::read(is, string); }
+        template<typename Stream>
+        void readStatic(Stream& is, std::wstring& string) { DeserializerImpl<C>::read(is, string); }
+#if __cplusplus >= 201703L
+        template<typename Stream>
+        void readStatic(Stream& is, std::pmr::string& string) { DeserializerImpl<C>::read(is, string); }
+        template<typename Stream>
+        void readStatic(Stream& is, std::string_view& string) { DeserializerImpl<C>::read(is, string); }
+        template<typename Stream>
+        void readStatic(Stream& is, std::wstring_view& string) { DeserializerImpl<C>::read(is, string); }
+#endif
+        /** STL containers **/
+        template<typename Stream, typename K, typename T>
+        void readStatic(Stream& is, std::pair<K, T>& container)
+        {
+            StaticSTLPair<K, T> tmp(container, "std::pair");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, std::size_t N>
+        void readStatic(Stream& is, std::array<T, N>& container)
+        {
+            StaticSTLList<std::array<T, N>, T> tmp(container, "std::array");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename A>
+        void readStatic(Stream& is, std::deque<T, A>& container)
+        {
+            StaticSTLList<std::deque<T, A>, T> tmp(container, "std::deque");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename A>
+        void readStatic(Stream& is, std::forward_list<T, A>& container)
+        {
+            StaticSTLList<std::forward_list<T, A>, T> tmp(container, "std::forward_list");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+            container.reverse(); // Trick because the forward list only has push_front
+        }
+        template<typename Stream, typename T, typename A>
+        void readStatic(Stream& is, std::list<T, A>& container)
+        {
+            StaticSTLList<std::list<T, A>, T> tmp(container, "std::list");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename P, typename A>
+        void readStatic(Stream& is, std::map<K, T, P, A>& container)
+        {
+            StaticSTLMap<std::map<K, T, P, A>, K, T> tmp(container, "std::map");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename P, typename A>
+        void readStatic(Stream& is, std::multimap<K, T, P, A>& container)
+        {
+            StaticSTLMap<std::multimap<K, T, P, A>, K, T> tmp(container, "std::multimap");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename P, typename A>
+        void readStatic(Stream& is, std::multiset<T, P, A>& container)
+        {
+            StaticSTLSet<std::multiset<T, P, A>, T> tmp(container, "std::multiset");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename S, typename P>
+        void readStatic(Stream& is, std::priority_queue<T, S, P>& container)
+        {
+            StaticSTLQueue<std::priority_queue<T, S, P>, T> tmp(container, "std::priority_queue");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename S>
+        void readStatic(Stream& is, std::queue<T, S>& container)
+        {
+            StaticSTLQueue<std::queue<T, S>, T> tmp(container, "std::queue");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename P, typename A>
+        void readStatic(Stream& is, std::set<T, P, A>& container)
+        {
+            StaticSTLSet<std::set<T, P, A>, T> tmp(container, "std::set");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename S>
+        void readStatic(Stream& is, std::stack<T, S>& container)
+        {
+            StaticSTLQueue<std::stack<T, S>, T> tmp(container, "std::stack");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename H, typename E, typename A>
+        void readStatic(Stream& is, std::unordered_map<K, T, H, E, A>& container)
+        {
+            StaticSTLMap<std::unordered_map<K, T, H, E, A>, K, T> tmp(container, "std::unordered_map");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename K, typename T, typename H, typename E, typename A>
+        void readStatic(Stream& is, std::unordered_multimap<K, T, H, E, A>& container)
+        {
+            StaticSTLMap<std::unordered_multimap<K, T, H, E, A>, K, T> tmp(container, "std::unordered_multimap");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename H, typename E, typename A>
+        void readStatic(Stream& is, std::unordered_multiset<T, H, E, A>& container)
+        {
+            StaticSTLSet<std::unordered_multiset<T, H, E, A>, T> tmp(container, "std::unordered_multiset");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename H, typename E, typename A>
+        void readStatic(Stream& is, std::unordered_set<T, H, E, A>& container)
+        {
+            StaticSTLSet<std::unordered_set<T, H, E, A>, T> tmp(container, "std::unordered_set");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        template<typename Stream, typename T, typename A>
+        void readStatic(Stream& is, std::vector<T, A>& container)
+        {
+            StaticSTLList<std::vector<T, A>, T> tmp(container, "std::vector");
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        /** Vectors whose elements are encoded with a number codec **/
+        template<typename Stream, typename T>
+        void readStatic(Stream& is, T& container, NumberCodec codec)
+        {
+            StaticSTLList<T, typename T::value_type> tmp(container, "std::vector", codec);
+            static_cast<C*>(this)->readSTLContainer(is, tmp);
+        }
+        /** Serializable classes **/
+        template<typename Stream, typename T>
+        void readStatic(Stream& is, T& object, typename std::enable_if<!(std::is_abstract<SerializableClass<T> >::value) >::type* = 0)
+        {
+            StaticClass<T> tmp(object);
+            static_cast<C*>(this)->readSerializable(is, tmp);
+        }
+        /** Non serializable classes are null **/
+        template<typename Stream, typename T>
+        void readStatic(Stream& is, T& object, typename std::enable_if<(!(std::is_arithmetic<T>::value)&&!(std::is_enum<T>::value)&&(std::is_abstract<SerializableClass<T> >::value)) >::type* = 0)
+        {
+            static_cast<C*>(this)->readNull(is);
+        }
+        /** Enums are converted to int **/
+        template<typename Stream, typename T>
+        void readStatic(Stream& is, T& object, typename std::enable_if<((std::is_enum<T>::value)&&(std::is_abstract<SerializableClass<T> >::value)) >::type* = 0)
+        {
+            int tmp;
+            DeserializerImpl<C>::read(is, tmp);
+            object = static_cast<T>(tmp);
+        }
+#if __cplusplus >= 201703L
+
+    protected:
+        StringPool& stringPool()
+        {
+            if(this->_pool == 0)
+                throw StringPoolException();
+            return *this->_pool;
+        }
+
+        std::string _string;
+        std::wstring _wstring;
+#endif
     };
 
+    /* -- STATICALLY DISPATCHED SERIALIZATION -- */
+
+    /** Serializes the value with the format F. The calls are resolved at compile time, so the whole 
+    serialization can be inlined. The virtual interface remains for formats selected at run time **/
+    template<class F, typename T>
+    inline void serialize(Writer& os, const T& value)
+    {
+        F sez;
+        sez.writeStatic(os, value);
+    }
+    template<class F, typename T>
+    inline void serialize(std::ostream& os, const T& value)
+    {
+        StreamWriter writer(os);
+        serialize<F>(writer, value);
+    }
+    template<class F, typename T>
+    inline void serialize(std::wostream& os, const T& value)
+    {
+        F sez;
+        sez.writeStatic(os, value);
+    }
+
+    /** Deserializes the value with the format F. The calls are resolved at compile time **/
+    template<class F, typename T>
+    inline void deserialize(Reader& is, T& value)
+    {
+        F dez;
+        dez.readStatic(is, value);
+    }
+    template<class F, typename T>
+    inline void deserialize(std::istream& is, T& value)
+    {
+        StreamReader reader(is);
+        deserialize<F>(reader, value);
+    }
+    template<class F, typename T>
+    inline void deserialize(std::wistream& is, T& value)
+    {
+        F dez;
+        dez.readStatic(is, value);
+    }
+#if __cplusplus >= 201703L
+    /** Deserializes a new value of type T with the format F. A pmr-aware value and all its contents 
+    are allocated in the memory resource **/
+    template<class F, typename T>
+    inline T deserialize(Reader& is, std::pmr::memory_resource* resource)
+    {
+        T value(makeElement<T>(std::pmr::polymorphic_allocator<char>(resource)));
+        deserialize<F>(is, value);
+        return value;
+    }
+    template<class F, typename T>
+    inline T deserialize(std::istream& is, std::pmr::memory_resource* resource)
+    {
+        StreamReader reader(is);
+        return deserialize<F, T>(reader, resource);
+    }
+#endif
+
     /* -- CHARACTER CONVERSION UTILS -- */
 
     /** This function convert a char to a wchar_t **/
@@ -1500,55 +2911,72 @@ namespace Seza
     }
 
     /** -- SOME SERIALIZE CLASS METHODS -- */
-    inline void Serializable::serializeElemName(Serializer* sez, std::ostream& os) const 
+    inline void Serializable::serializeElemValue(Serializer* sez, Writer& os) const 
     { 
-        sez->write(os, _it->first); 
+        _it->serialize(sez, os, _instance); 
     }
 
-    inline void Serializable::serializeElemName(Serializer* sez, std::wostream& os) const 
+    inline void Serializable::serializeElemValue(Serializer* sez, std::wostream& os) const 
     { 
-        sez->write(os, _it->first); 
+        _it->wserialize(sez, os, _instance); 
     }
 
-    inline void Serializable::serializeElemValue(Serializer* sez, std::ostream& os) const 
-    { 
-        _it->second->serializeElem(sez, os); 
+    inline bool Serializable::deserializeElemName(Deserializer* dez, Reader& is) const
+    {
+        return ((_it = dez->read(is, _members)) != 0);
     }
 
-    inline void Serializable::serializeElemValue(Serializer* sez, std::wostream& os) const 
-    { 
-        _it->second->serializeElem(sez, os); 
+    inline bool Serializable::deserializeElemName(Deserializer* dez, std::wistream& is) const
+    {
+        return ((_it = dez->read(is, _members)) != 0);
     }
 
-    inline bool Serializable::deserializeElemName(Deserializer* dez, std::istream& is) const
+    inline void Serializable::deserializeElemValue(Deserializer* dez, Reader& is) const
     {
-        std::string memberName;
-        dez->read(is, memberName);
+        _it->deserialize(dez, is, _instance);
+    }
 
-        if((_it = _members.find(memberName)) != _members.end())
-            return true;
-    
-        return false;
+    inline void Serializable::deserializeElemValue(Deserializer* dez, std::wistream& is) const
+    {
+        _it->wdeserialize(dez, is, _instance);
     }
 
-    inline bool Serializable::deserializeElemName(Deserializer* dez, std::wistream& is) const
+    /** -- SOME MEMBER CODEC METHODS -- */
+    template<class C, typename T, T C::*M>
+    void Member<C, T, M>::serialize(Serializer* sez, Writer& os, void* instance)
     {
-        std::string memberName;
-        dez->read(is, memberName);
+        sez->write(os, static_cast<C*>(instance)->*M);
+    }
 
-        if((_it = _members.find(memberName)) != _members.end())
-            return true;
-    
-        return false;
+    template<class C, typename T, T C::*M>
+    void Member<C, T, M>::serialize(Serializer* sez, std::wostream& os, void* instance)
+    {
+        sez->write(os, static_cast<C*>(instance)->*M);
     }
 
-    inline void Serializable::deserializeElemValue(Deserializer* dez, std::istream& is) const
+    template<class C, typename T, T C::*M>
+    void Member<C, T, M>::deserialize(Deserializer* dez, Reader& is, void* instance)
     {
-        _it->second->deserializeElem(dez, is);
+        dez->read(is, static_cast<C*>(instance)->*M);
     }
 
-    inline void Serializable::deserializeElemValue(Deserializer* dez, std::wistream& is) const
+    template<class C, typename T, T C::*M>
+    void Member<C, T, M>::deserialize(Deserializer* dez, std::wistream& is, void* instance)
+    {
+        dez->read(is, static_cast<C*>(instance)->*M);
+    }
+
+    template<class C, typename T, T C::*M, NumberCodec K>
+    void CodecMember<C, T, M, K>::serialize(Serializer* sez, Writer& os, void* instance)
+    {
+        SerializableSTLList<T, typename T::value_type> tmp(static_cast<C*>(instance)->*M, "std::vector", K);
+        sez->write(os, (const SerializableSTLContainer&) tmp);
+    }
+
+    template<class C, typename T, T C::*M, NumberCodec K>
+    void CodecMember<C, T, M, K>::deserialize(Deserializer* dez, Reader& is, void* instance)
     {
-        _it->second->deserializeElem(dez, is);
+        SerializableSTLList<T, typename T::value_type> tmp(static_cast<C*>(instance)->*M, "std::vector", K);
+        dez->read(is, (SerializableSTLContainer&) tmp);
     }
 }
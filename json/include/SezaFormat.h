@@ -0,0 +1,533 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace Seza
+{
+    /* -- INTEGER FORMATTING -- */
+
+    /** Decimal digits of the numbers from 00 to 99 **/
+    static const char digitPairs[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    /** Returns the count of decimal digits of value **/
+    inline unsigned int countDigits(unsigned long long value)
+    {
+        static const unsigned long long powers[] = 
+        {
+            0ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 
+            100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 
+            10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 
+            100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+        };
+
+#if defined(__GNUC__)
+        unsigned int bits = 64 - __builtin_clzll(value | 1);
+#else
+        unsigned int bits = 1;
+        for(unsigned long long tmp = value >> 1; tmp != 0; tmp >>= 1)
+            ++bits;
+#endif
+        // log10(2) ~ 1233 / 4096 gives the digits count or one more
+        unsigned int digits = (bits * 1233) >> 12;
+        return digits - (value < powers[digits]) + 1;
+    }
+
+    /** Writes the decimal digits of value backwards, ending just before end **/
+    template<typename T>
+    inline void writeDigits(char* end, T value)
+    {
+        while(value >= 100)
+        {
+            unsigned int pair = (unsigned int)(value % 100) * 2;
+            value /= 100;
+            end -= 2;
+            memcpy(end, digitPairs + pair, 2);
+        }
+
+        if(value >= 10)
+        {
+            end -= 2;
+            memcpy(end, digitPairs + (unsigned int)value * 2, 2);
+        }
+        else
+            *--end = (char)('0' + value);
+    }
+
+    /** Returns the count of characters needed to format value **/
+    template<typename T>
+    inline unsigned int formattedLength(T value, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type* = 0)
+    {
+        return countDigits(value);
+    }
+    template<typename T>
+    inline unsigned int formattedLength(T value, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type* = 0)
+    {
+        typedef typename std::make_unsigned<T>::type Unsigned;
+        if(value < 0)
+            return countDigits((Unsigned)(Unsigned(0) - (Unsigned)value)) + 1;
+        return countDigits((Unsigned)value);
+    }
+
+    /** Formats value in buffer, which must have room for its formatted length. 
+    Returns the position after the last character written **/
+    template<typename T>
+    inline char* formatInteger(char* buffer, T value, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type* = 0)
+    {
+        char* end = buffer + countDigits(value);
+        if(value <= std::numeric_limits<unsigned int>::max())
+            writeDigits(end, (unsigned int)value); // 32 bits divisions are faster
+        else
+            writeDigits(end, (unsigned long long)value);
+        return end;
+    }
+    template<typename T>
+    inline char* formatInteger(char* buffer, T value, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type* = 0)
+    {
+        typedef typename std::make_unsigned<T>::type Unsigned;
+        if(value < 0)
+        {
+            *buffer++ = '-';
+            return formatInteger(buffer, (Unsigned)(Unsigned(0) - (Unsigned)value));
+        }
+        return formatInteger(buffer, (Unsigned)value);
+    }
+
+    /* -- FLOATING POINT FORMATTING -- */
+
+    /** Maximum length of a formatted floating point number **/
+    static const size_t maxFloatLength = 32;
+
+    /** Shortest round-trip conversion of binary floating point numbers to decimal, 
+    based on the Grisu2 algorithm by Florian Loitsch **/
+    namespace Grisu
+    {
+        /** Floating point number f * 2^e with a 64 bits significand **/
+        struct DiyFp
+        {
+            DiyFp(uint64_t f_, int e_) : f(f_), e(e_) {}
+
+            static DiyFp sub(const DiyFp& x, const DiyFp& y) { return DiyFp(x.f - y.f, x.e); }
+
+            /** Returns x * y rounded to 64 bits **/
+            static DiyFp mul(const DiyFp& x, const DiyFp& y)
+            {
+                uint64_t xLo = x.f & 0xFFFFFFFFu, xHi = x.f >> 32;
+                uint64_t yLo = y.f & 0xFFFFFFFFu, yHi = y.f >> 32;
+
+                uint64_t p0 = xLo * yLo;
+                uint64_t p1 = xLo * yHi;
+                uint64_t p2 = xHi * yLo;
+                uint64_t p3 = xHi * yHi;
+
+                uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+                q += uint64_t(1) << 31; // round, ties up
+
+                return DiyFp(p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64);
+            }
+
+            static DiyFp normalize(DiyFp x)
+            {
+                while((x.f >> 63) == 0)
+                {
+                    x.f <<= 1;
+                    x.e--;
+                }
+                return x;
+            }
+
+            static DiyFp normalizeTo(const DiyFp& x, int e) { return DiyFp(x.f << (x.e - e), e); }
+
+            uint64_t f;
+            int e;
+        };
+
+        /** A number and the boundaries of the interval of numbers that round to it **/
+        struct Boundaries
+        {
+            Boundaries(const DiyFp& w_, const DiyFp& minus_, const DiyFp& plus_) : w(w_), minus(minus_), plus(plus_) {}
+
+            DiyFp w;
+            DiyFp minus;
+            DiyFp plus;
+        };
+
+        template<typename Float, typename Bits>
+        inline Boundaries computeBoundaries(Float value)
+        {
+            static const int precision = std::numeric_limits<Float>::digits; // including the hidden bit
+            static const int bias = std::numeric_limits<Float>::max_exponent - 1 + (precision - 1);
+            static const int minExponent = 1 - bias;
+            static const uint64_t hiddenBit = uint64_t(1) << (precision - 1);
+
+            Bits bits;
+            memcpy(&bits, &value, sizeof(bits));
+            uint64_t e = (uint64_t)bits >> (precision - 1);
+            uint64_t f = (uint64_t)bits & (hiddenBit - 1);
+
+            DiyFp v = (e == 0) ? DiyFp(f, minExponent) : DiyFp(f + hiddenBit, (int)e - bias);
+
+            // The lower boundary is closer when the significand is a power of two
+            bool lowerCloser = (f == 0) && (e > 1);
+            DiyFp plus = DiyFp::normalize(DiyFp(2 * v.f + 1, v.e - 1));
+            DiyFp minus = lowerCloser ? DiyFp(4 * v.f - 1, v.e - 2) : DiyFp(2 * v.f - 1, v.e - 1);
+
+            return Boundaries(DiyFp::normalize(v), DiyFp::normalizeTo(minus, plus.e), plus);
+        }
+
+        /** Cached power of ten 10^k ~ f * 2^e **/
+        struct CachedPower
+        {
+            uint64_t f;
+            int e;
+            int k;
+        };
+
+        /** Returns a cached power of ten c = 10^k such that the exponent of value * c is in [-60, -32] **/
+        inline CachedPower getCachedPower(int e)
+        {
+            static const CachedPower powers[] =
+            {
+            { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+            { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+            { 0xBE5691EF416BD60CULL, -1007, -284 },
+            { 0x8DD01FAD907FFC3CULL, -980, -276 },
+            { 0xD3515C2831559A83ULL, -954, -268 },
+            { 0x9D71AC8FADA6C9B5ULL, -927, -260 },
+            { 0xEA9C227723EE8BCBULL, -901, -252 },
+            { 0xAECC49914078536DULL, -874, -244 },
+            { 0x823C12795DB6CE57ULL, -847, -236 },
+            { 0xC21094364DFB5637ULL, -821, -228 },
+            { 0x9096EA6F3848984FULL, -794, -220 },
+            { 0xD77485CB25823AC7ULL, -768, -212 },
+            { 0xA086CFCD97BF97F4ULL, -741, -204 },
+            { 0xEF340A98172AACE5ULL, -715, -196 },
+            { 0xB23867FB2A35B28EULL, -688, -188 },
+            { 0x84C8D4DFD2C63F3BULL, -661, -180 },
+            { 0xC5DD44271AD3CDBAULL, -635, -172 },
+            { 0x936B9FCEBB25C996ULL, -608, -164 },
+            { 0xDBAC6C247D62A584ULL, -582, -156 },
+            { 0xA3AB66580D5FDAF6ULL, -555, -148 },
+            { 0xF3E2F893DEC3F126ULL, -529, -140 },
+            { 0xB5B5ADA8AAFF80B8ULL, -502, -132 },
+            { 0x87625F056C7C4A8BULL, -475, -124 },
+            { 0xC9BCFF6034C13053ULL, -449, -116 },
+            { 0x964E858C91BA2655ULL, -422, -108 },
+            { 0xDFF9772470297EBDULL, -396, -100 },
+            { 0xA6DFBD9FB8E5B88FULL, -369, -92 },
+            { 0xF8A95FCF88747D94ULL, -343, -84 },
+            { 0xB94470938FA89BCFULL, -316, -76 },
+            { 0x8A08F0F8BF0F156BULL, -289, -68 },
+            { 0xCDB02555653131B6ULL, -263, -60 },
+            { 0x993FE2C6D07B7FACULL, -236, -52 },
+            { 0xE45C10C42A2B3B06ULL, -210, -44 },
+            { 0xAA242499697392D3ULL, -183, -36 },
+            { 0xFD87B5F28300CA0EULL, -157, -28 },
+            { 0xBCE5086492111AEBULL, -130, -20 },
+            { 0x8CBCCC096F5088CCULL, -103, -12 },
+            { 0xD1B71758E219652CULL, -77, -4 },
+            { 0x9C40000000000000ULL, -50, 4 },
+            { 0xE8D4A51000000000ULL, -24, 12 },
+            { 0xAD78EBC5AC620000ULL, 3, 20 },
+            { 0x813F3978F8940984ULL, 30, 28 },
+            { 0xC097CE7BC90715B3ULL, 56, 36 },
+            { 0x8F7E32CE7BEA5C70ULL, 83, 44 },
+            { 0xD5D238A4ABE98068ULL, 109, 52 },
+            { 0x9F4F2726179A2245ULL, 136, 60 },
+            { 0xED63A231D4C4FB27ULL, 162, 68 },
+            { 0xB0DE65388CC8ADA8ULL, 189, 76 },
+            { 0x83C7088E1AAB65DBULL, 216, 84 },
+            { 0xC45D1DF942711D9AULL, 242, 92 },
+            { 0x924D692CA61BE758ULL, 269, 100 },
+            { 0xDA01EE641A708DEAULL, 295, 108 },
+            { 0xA26DA3999AEF774AULL, 322, 116 },
+            { 0xF209787BB47D6B85ULL, 348, 124 },
+            { 0xB454E4A179DD1877ULL, 375, 132 },
+            { 0x865B86925B9BC5C2ULL, 402, 140 },
+            { 0xC83553C5C8965D3DULL, 428, 148 },
+            { 0x952AB45CFA97A0B3ULL, 455, 156 },
+            { 0xDE469FBD99A05FE3ULL, 481, 164 },
+            { 0xA59BC234DB398C25ULL, 508, 172 },
+            { 0xF6C69A72A3989F5CULL, 534, 180 },
+            { 0xB7DCBF5354E9BECEULL, 561, 188 },
+            { 0x88FCF317F22241E2ULL, 588, 196 },
+            { 0xCC20CE9BD35C78A5ULL, 614, 204 },
+            { 0x98165AF37B2153DFULL, 641, 212 },
+            { 0xE2A0B5DC971F303AULL, 667, 220 },
+            { 0xA8D9D1535CE3B396ULL, 694, 228 },
+            { 0xFB9B7CD9A4A7443CULL, 720, 236 },
+            { 0xBB764C4CA7A44410ULL, 747, 244 },
+            { 0x8BAB8EEFB6409C1AULL, 774, 252 },
+            { 0xD01FEF10A657842CULL, 800, 260 },
+            { 0x9B10A4E5E9913129ULL, 827, 268 },
+            { 0xE7109BFBA19C0C9DULL, 853, 276 },
+            { 0xAC2820D9623BF429ULL, 880, 284 },
+            { 0x80444B5E7AA7CF85ULL, 907, 292 },
+            { 0xBF21E44003ACDD2DULL, 933, 300 },
+            { 0x8E679C2F5E44FF8FULL, 960, 308 },
+            { 0xD433179D9C8CB841ULL, 986, 316 },
+            { 0x9E19DB92B4E31BA9ULL, 1013, 324 }
+            };
+            static const int minDecimalExponent = -300;
+            static const int decimalStep = 8;
+            static const int alpha = -60;
+
+            int f = alpha - e - 1;
+            int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0); // ceil(f * log10(2))
+            int index = (-minDecimalExponent + k + (decimalStep - 1)) / decimalStep;
+
+            return powers[index];
+        }
+
+        /** Returns the largest power of ten not greater than n and its count of digits **/
+        inline int findLargestPow10(uint32_t n, uint32_t& pow10)
+        {
+            static const uint32_t powers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+            int digits = 10;
+            while(n < powers[digits - 1])
+                --digits;
+            pow10 = powers[digits - 1];
+            return digits;
+        }
+
+        /** Moves the last digit towards the exact value while it stays in the rounding interval **/
+        inline void round(char* buffer, int length, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t tenK)
+        {
+            while((rest < dist) && (delta - rest >= tenK) && ((rest + tenK < dist) || (dist - rest > rest + tenK - dist)))
+            {
+                buffer[length - 1]--;
+                rest += tenK;
+            }
+        }
+
+        /** Generates the shortest digits of a number in [minus, plus] closest to w **/
+        inline void generateDigits(char* buffer, int& length, int& exponent, const DiyFp& minus, const DiyFp& w, const DiyFp& plus)
+        {
+            uint64_t delta = DiyFp::sub(plus, minus).f;
+            uint64_t dist = DiyFp::sub(plus, w).f;
+
+            DiyFp one(uint64_t(1) << -plus.e, plus.e);
+            uint32_t p1 = (uint32_t)(plus.f >> -one.e); // integral part
+            uint64_t p2 = plus.f & (one.f - 1);          // fractional part
+
+            uint32_t pow10;
+            int n = findLargestPow10(p1, pow10);
+
+            while(n > 0)
+            {
+                buffer[length++] = (char)('0' + p1 / pow10);
+                p1 %= pow10;
+                n--;
+
+                uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+                if(rest <= delta)
+                {
+                    exponent += n;
+                    round(buffer, length, dist, delta, rest, (uint64_t)pow10 << -one.e);
+                    return;
+                }
+                pow10 /= 10;
+            }
+
+            int m = 0;
+            for(;;)
+            {
+                p2 *= 10;
+                buffer[length++] = (char)('0' + (p2 >> -one.e));
+                p2 &= one.f - 1;
+                m++;
+
+                delta *= 10;
+                dist *= 10;
+                if(p2 <= delta)
+                    break;
+            }
+
+            exponent -= m;
+            round(buffer, length, dist, delta, p2, one.f);
+        }
+
+        /** Writes the shortest digits of a positive finite value. The value is digits * 10^exponent **/
+        template<typename Float, typename Bits>
+        inline void grisu2(char* buffer, int& length, int& exponent, Float value)
+        {
+            Boundaries boundaries = computeBoundaries<Float, Bits>(value);
+            CachedPower cached = getCachedPower(boundaries.plus.e);
+            DiyFp c(cached.f, cached.e);
+
+            DiyFp w = DiyFp::mul(boundaries.w, c);
+            DiyFp minus = DiyFp::mul(boundaries.minus, c);
+            DiyFp plus = DiyFp::mul(boundaries.plus, c);
+
+            // Shrink the interval to be safe with the rounding errors of mul
+            length = 0;
+            exponent = -cached.k;
+            generateDigits(buffer, length, exponent, DiyFp(minus.f + 1, minus.e), w, DiyFp(plus.f - 1, plus.e));
+        }
+
+        /** Writes the exponent of the scientific notation **/
+        inline char* formatExponent(char* buffer, int e)
+        {
+            if(e < 0)
+            {
+                *buffer++ = '-';
+                e = -e;
+            }
+            else
+                *buffer++ = '+';
+
+            if(e >= 100)
+            {
+                *buffer++ = (char)('0' + e / 100);
+                e %= 100;
+                *buffer++ = (char)('0' + e / 10);
+            }
+            else if(e >= 10)
+                *buffer++ = (char)('0' + e / 10);
+            *buffer++ = (char)('0' + e % 10);
+
+            return buffer;
+        }
+
+        /** Places the decimal point in the digits of buffer. Returns the end of the number **/
+        inline char* formatDigits(char* buffer, int length, int exponent)
+        {
+            static const int minExponent = -4;
+            static const int maxExponent = 15;
+
+            int point = length + exponent; // position of the decimal point
+
+            if((length <= point) && (point <= maxExponent))
+            {
+                // digits[000]
+                memset(buffer + length, '0', point - length);
+                return buffer + point;
+            }
+            if((0 < point) && (point <= maxExponent))
+            {
+                // dig.its
+                memmove(buffer + point + 1, buffer + point, length - point);
+                buffer[point] = '.';
+                return buffer + length + 1;
+            }
+            if((minExponent < point) && (point <= 0))
+            {
+                // 0.[000]digits
+                memmove(buffer + 2 - point, buffer, length);
+                buffer[0] = '0';
+                buffer[1] = '.';
+                memset(buffer + 2, '0', -point);
+                return buffer + 2 - point + length;
+            }
+
+            // d.igitse+123
+            if(length > 1)
+            {
+                memmove(buffer + 2, buffer + 1, length - 1);
+                buffer[1] = '.';
+                buffer += length + 1;
+            }
+            else
+                buffer += 1;
+
+            *buffer++ = 'e';
+            return formatExponent(buffer, point - 1);
+        }
+
+        template<typename Float, typename Bits>
+        inline char* format(char* buffer, Float value)
+        {
+            if(value != value || value - value != 0) // NaN and infinity are not valid JSON numbers
+            {
+                memcpy(buffer, "null", 4);
+                return buffer + 4;
+            }
+
+            if(std::signbit(value))
+            {
+                *buffer++ = '-';
+                value = -value;
+            }
+
+            if(value == 0)
+            {
+                *buffer = '0';
+                return buffer + 1;
+            }
+
+            int length, exponent;
+            grisu2<Float, Bits>(buffer, length, exponent, value);
+            return formatDigits(buffer, length, exponent);
+        }
+    }
+
+    /** Formats value with the shortest decimal representation that reads back to the same value. 
+    Buffer must have room for maxFloatLength characters. Returns the position after the last character written **/
+    inline char* formatFloat(char* buffer, float value)
+    {
+        return Grisu::format<float, uint32_t>(buffer, value);
+    }
+    inline char* formatFloat(char* buffer, double value)
+    {
+        return Grisu::format<double, uint64_t>(buffer, value);
+    }
+    /** Long doubles holding a double value are formatted as doubles. Otherwise they are 
+    formatted with all the significant digits of the type **/
+    inline char* formatFloat(char* buffer, long double value)
+    {
+        if((value != value) || ((long double)(double)value == value))
+            return formatFloat(buffer, (double)value);
+
+        int length = snprintf(buffer, maxFloatLength, "%.*Lg", std::numeric_limits<long double>::max_digits10, value);
+        for(int i = 0; i < length; ++i)
+        {
+            if(buffer[i] == ',') // decimal point of LC_NUMERIC locales other than C
+                buffer[i] = '.';
+        }
+        return buffer + length;
+    }
+}
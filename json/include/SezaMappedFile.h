@@ -0,0 +1,134 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <exception>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SEZA_HAS_MMAP
+#else
+#include <stdio.h>
+#include <vector>
+#endif
+
+#include "SezaReader.h"
+
+namespace Seza
+{
+    /* -- EXCEPTIONS -- */
+
+    /** This exception is thrown when a file cannot be opened or mapped **/
+    class MappedFileException : public std::exception
+    {
+    public:
+      const char* what() const throw() { return "The file cannot be mapped!\n"; }
+    };
+
+    /* -- MEMORY MAPPED FILES -- */
+
+    /** Reader over a whole file mapped in memory. The file is read in place by the deserializer, 
+    and the kernel is told that the pages are accessed sequentially **/
+    class MappedFileReader : public BufferReader
+    {
+    public:
+        MappedFileReader(const std::string& path) :
+            _data(0),
+            _size(0)
+        {
+#if defined(SEZA_HAS_MMAP)
+            int fd = open(path.c_str(), O_RDONLY);
+            if(fd < 0)
+                throw MappedFileException();
+
+            struct stat status;
+            if(fstat(fd, &status) != 0)
+            {
+                close(fd);
+                throw MappedFileException();
+            }
+            _size = (size_t)status.st_size;
+
+            if(_size > 0)
+            {
+                void* data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(data == MAP_FAILED)
+                {
+                    close(fd);
+                    throw MappedFileException();
+                }
+                madvise(data, _size, MADV_SEQUENTIAL);
+                _data = (const char*)data;
+            }
+            close(fd);
+#else
+            FILE* file = fopen(path.c_str(), "rb");
+            if(file == 0)
+                throw MappedFileException();
+
+            char block[4096];
+            size_t count;
+            while((count = fread(block, 1, sizeof(block), file)) > 0)
+                _copy.insert(_copy.end(), block, block + count);
+            fclose(file);
+
+            _size = _copy.size();
+            _data = _copy.empty() ? 0 : &_copy[0];
+#endif
+            _begin = _cursor = _data;
+            _end = _data + _size;
+        }
+        ~MappedFileReader()
+        {
+#if defined(SEZA_HAS_MMAP)
+            if(_data != 0)
+                munmap(const_cast<char*>(_data), _size);
+#endif
+        }
+
+        /** Returns the contents of the file **/
+        const char* data() const { return _data; }
+        /** Returns the size of the file **/
+        size_t size() const { return _size; }
+
+    private:
+        MappedFileReader(const MappedFileReader&);
+        MappedFileReader& operator=(const MappedFileReader&);
+
+        const char* _data;
+        size_t _size;
+#if !defined(SEZA_HAS_MMAP)
+        std::vector<char> _copy;
+#endif
+    };
+}
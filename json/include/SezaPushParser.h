@@ -0,0 +1,367 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) && defined(__GNUC__)
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#define SEZA_HAS_UCONTEXT
+#endif
+
+#include "Seza.h"
+
+namespace Seza
+{
+    /* -- EXCEPTIONS -- */
+
+    /** This exception is thrown when the input of a push parser ends before the value is complete **/
+    class PushParserException : public std::exception
+    {
+    public:
+      const char* what() const throw() { return "The input ended before the value was complete!\n"; }
+    };
+
+    /** This exception is thrown when the input is nested deeper than the stack of a push parser holds **/
+    class PushParserDepthException : public PushParserException
+    {
+    public:
+      const char* what() const throw() { return "The input is nested deeper than the stack of the push parser!\n"; }
+    };
+
+    /* -- PUSH PARSER -- */
+
+    /** Deserializes a value from input given in chunks of any size, as they arrive. The deserializer 
+    runs on a stack of its own, which keeps the classes and containers pending to be completed. When a 
+    chunk is exhausted the parser is suspended, and the next chunk resumes it exactly where it stopped, 
+    even in the middle of a string or a number. Any format that reads from a Reader can be pushed.
+    Input nested deeper than the stack holds throws a PushParserDepthException. The deserializer is 
+    not used for other values while the parser reads. Without ucontext the chunks are buffered and 
+    the value is read when the input finishes **/
+    class PushParser
+    {
+    public:
+        static const size_t defaultStackSize = 1 << 20;
+        /** Stack kept below the deepest nesting for the reading of a value and the throwing of the 
+        exception, up to a quarter of the stack **/
+        static const size_t stackMargin = 1 << 16;
+
+        template<typename T>
+        PushParser(Deserializer& deserializer, T& value, size_t stackSize = defaultStackSize) :
+            _read([&deserializer, &value](Reader& is) { deserializer.read(is, value); }),
+            _deserializer(deserializer),
+            _input(*this),
+            _chunk(0),
+            _chunkEnd(0),
+            _started(false),
+            _done(false),
+            _finished(false),
+            _cancelled(false)
+        {
+#if defined(SEZA_HAS_UCONTEXT)
+            _stack.reset(new Stack(stackSize));
+            start();
+#endif
+        }
+        /** A parser destroyed in the middle of the value unwinds its stack, so the pending 
+        objects are destroyed too **/
+        ~PushParser() { cancel(); }
+        PushParser(const PushParser&) = delete;
+        PushParser& operator=(const PushParser&) = delete;
+
+        /** Reads the chunk, which is not used after the call. Returns true when the value is complete. 
+        The bytes after the value are ignored **/
+        bool feed(const char* data, size_t size)
+        {
+            if(_error)
+                std::rethrow_exception(_error);
+            if(_done || _finished)
+                return _done;
+#if defined(SEZA_HAS_UCONTEXT)
+            _chunk = data;
+            _chunkEnd = data + size;
+            resume();
+#else
+            _buffer.insert(_buffer.end(), data, data + size);
+#endif
+            return _done;
+        }
+        bool feed(const std::string& chunk) { return feed(chunk.data(), chunk.size()); }
+
+        /** Ends the input. Values like numbers that may continue are completed here. Throws if the 
+        value is not complete **/
+        void finish()
+        {
+            if(!_done && !_error)
+            {
+                _finished = true;
+#if defined(SEZA_HAS_UCONTEXT)
+                _chunk = _chunkEnd = 0;
+                resume();
+#else
+                BufferReader reader(_buffer.data(), _buffer.size());
+                _read(reader);
+                _done = true;
+#endif
+            }
+            if(_error)
+                std::rethrow_exception(_error);
+        }
+
+        /** Checks if the value is complete **/
+        bool done() const { return _done; }
+
+        /** Starts reading the value again from new input, after it is complete, failed or abandoned. 
+        The pending objects of an abandoned value are destroyed. The value is read over what it holds **/
+        void reset()
+        {
+            cancel();
+            _input.reset();
+            _chunk = _chunkEnd = 0;
+            _started = _done = _finished = _cancelled = false;
+            _error = std::exception_ptr();
+#if defined(SEZA_HAS_UCONTEXT)
+            start();
+#else
+            _buffer.clear();
+#endif
+        }
+
+    protected:
+        /** Reader over the chunks fed. Bytes are read in place from the current chunk, and only the 
+        ones required contiguously across two chunks are copied **/
+        class Input : public Reader
+        {
+        public:
+            Input(PushParser& parser) : _parser(parser) {}
+
+            void reset()
+            {
+                _cursor = _end = 0;
+                std::vector<char>().swap(_carry);
+            }
+
+        protected:
+            virtual bool underflow()
+            {
+                while(_parser._chunk == _parser._chunkEnd)
+                {
+                    if(!_parser.suspend())
+                        return false;
+                }
+                _cursor = _parser._chunk;
+                _end = _parser._chunkEnd;
+                _parser._chunk = _parser._chunkEnd;
+                return true;
+            }
+
+            virtual bool refill(size_t size)
+            {
+                std::vector<char> carry(_cursor, _end);
+                while(carry.size() < size)
+                {
+                    if(_parser._chunk == _parser._chunkEnd)
+                    {
+                        if(!_parser.suspend())
+                            break;
+                        continue;
+                    }
+                    size_t count = std::min(size - carry.size(), (size_t)(_parser._chunkEnd - _parser._chunk));
+                    carry.insert(carry.end(), _parser._chunk, _parser._chunk + count);
+                    _parser._chunk += count;
+                }
+                _carry.swap(carry);
+                _cursor = _carry.data();
+                _end = _cursor + _carry.size();
+                return _carry.size() >= size;
+            }
+
+            PushParser& _parser;
+            std::vector<char> _carry;
+        };
+
+        /** Thrown in the stack of the parser to unwind it **/
+        struct Cancelled {};
+
+#if defined(SEZA_HAS_UCONTEXT)
+        /** Parser entering its stack, which makecontext can only be given as ints **/
+        static PushParser*& entering()
+        {
+            static thread_local PushParser* parser = 0;
+            return parser;
+        }
+
+        /** Prepares the stack of the parser to run from its entry **/
+        void start()
+        {
+            getcontext(&_parser);
+            _parser.uc_stack.ss_sp = _stack->data();
+            _parser.uc_stack.ss_size = _stack->size();
+            _parser.uc_link = 0;
+            makecontext(&_parser, &PushParser::run, 0);
+            _entered = false;
+        }
+
+        /** Entry of the stack of the parser. It never returns, the caller is jumped to when the value ends **/
+        static void run()
+        {
+            PushParser* parser = entering();
+            const void* limit = parser->_deserializer.getStackLimit();
+            size_t margin = parser->_stack->size() / 4;
+            parser->_deserializer.setStackLimit(parser->_stack->data() + ((margin < stackMargin) ? margin : stackMargin));
+            try
+            {
+                parser->_read(parser->_input);
+            }
+            catch(const StackLimitException&)
+            {
+                parser->_error = std::make_exception_ptr(PushParserDepthException());
+            }
+            catch(...)
+            {
+                parser->_error = std::current_exception();
+            }
+            parser->_deserializer.setStackLimit(limit);
+            parser->_done = true;
+            jump(parser->_callerJump);
+        }
+
+        /** The stacks are switched with the jump buffers of the compiler, which do not save the signal 
+        mask with a system call like swapcontext. Only the first entry goes through setcontext. Jumps 
+        are taken from functions other than the ones that set their buffers **/
+        __attribute__((noinline)) static void jump(void** buffer) { __builtin_longjmp(buffer, 1); }
+
+        /** Switches to the stack of the parser until it needs the next chunk or ends **/
+        void resume()
+        {
+            switchToParser();
+            if(_error)
+                std::rethrow_exception(_error);
+        }
+
+        __attribute__((noinline)) void switchToParser()
+        {
+            _started = true;
+            if(__builtin_setjmp(_callerJump) == 0)
+            {
+                if(_entered)
+                    jump(_parserJump);
+                _entered = true;
+                entering() = this;
+                setcontext(&_parser);
+            }
+        }
+
+        /** Switches back to the caller until the next chunk. Returns false at the end of the input **/
+        __attribute__((noinline)) bool suspend()
+        {
+            if(_finished)
+                return false;
+            if(__builtin_setjmp(_parserJump) == 0)
+                jump(_callerJump);
+            if(_cancelled)
+                throw Cancelled();
+            return !_finished;
+        }
+
+        /** Unwinds the stack of a value not complete **/
+        void cancel()
+        {
+            if(_started && !_done)
+            {
+                _cancelled = true;
+                switchToParser();
+            }
+        }
+#else
+        bool suspend() { return false; }
+        void cancel() {}
+#endif
+
+        std::function<void(Reader&)> _read;
+        Deserializer& _deserializer;
+        Input _input;
+        const char* _chunk;
+        const char* _chunkEnd;
+        bool _started;
+        bool _done;
+        bool _finished;
+        bool _cancelled;
+        std::exception_ptr _error;
+#if defined(SEZA_HAS_UCONTEXT)
+        /** Stack of the parser, mapped with an inaccessible guard page below it. Deep input is refused 
+        by the stack limit of the deserializer, and the guard page stops anything that gets past it 
+        from writing over the memory below **/
+        class Stack
+        {
+        public:
+            Stack(size_t size)
+            {
+                _guard = (size_t)sysconf(_SC_PAGESIZE);
+                _size = (size + _guard - 1) / _guard * _guard + _guard;
+                _base = mmap(0, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(_base == MAP_FAILED)
+                    throw std::bad_alloc();
+                if(mprotect(_base, _guard, PROT_NONE) != 0)
+                {
+                    munmap(_base, _size);
+                    throw std::bad_alloc();
+                }
+            }
+            ~Stack() { munmap(_base, _size); }
+            Stack(const Stack&) = delete;
+            Stack& operator=(const Stack&) = delete;
+
+            char* data() const { return (char*)_base + _guard; }
+            size_t size() const { return _size - _guard; }
+
+        private:
+            void* _base;
+            size_t _size;
+            size_t _guard;
+        };
+
+        std::unique_ptr<Stack> _stack;
+        ucontext_t _parser;
+        bool _entered;
+        void* _callerJump[5];
+        void* _parserJump[5];
+#else
+        std::vector<char> _buffer;
+#endif
+    };
+}
@@ -0,0 +1,301 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <stdint.h>
+#include <string.h>
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace Seza
+{
+    /* -- READER INTERFACE -- */
+
+    /** Contiguous input source. Bytes are consumed from the buffer [_cursor, _end) and 
+    underflow() is only called when it is exhausted **/
+    class Reader
+    {
+    public:
+        static const int eof = -1;
+
+        Reader() : _cursor(0), _end(0), _base(0), _mark(0), _marksEnd(0), _count(0), _countsEnd(0) {}
+        virtual ~Reader() {}
+
+        /** Returns the next byte without consuming it, or eof **/
+        int peek()
+        {
+            if((_cursor == _end) && !underflow())
+                return eof;
+            return (unsigned char)*_cursor;
+        }
+        /** Consumes and returns the next byte, or eof **/
+        int get()
+        {
+            if((_cursor == _end) && !underflow())
+                return eof;
+            return (unsigned char)*_cursor++;
+        }
+        /** Makes at least one byte available. Returns false at the end of the input **/
+        bool fill() { return (_cursor != _end) || underflow(); }
+        /** Tries to make size contiguous bytes available. Returns false if the input ends before **/
+        bool require(size_t size) { return ((size_t)(_end - _cursor) >= size) || refill(size); }
+
+        /** Available bytes **/
+        const char* cursor() const { return _cursor; }
+        const char* end() const { return _end; }
+        size_t available() const { return (size_t)(_end - _cursor); }
+        /** Consumes the available bytes until cursor **/
+        void seek(const char* cursor) { _cursor = cursor; }
+        void skip(size_t size) { _cursor += size; }
+
+        /** Readers over an index of the significant bytes of the input can jump over the bytes 
+        between them, like the whitespace of a text format **/
+        bool indexed() const { return _mark != 0; }
+        /** Moves the cursor to the first indexed byte at or after it **/
+        void skipToMark()
+        {
+            while((_mark != _marksEnd) && (_base + *_mark < _cursor))
+                ++_mark;
+            _cursor = (_mark != _marksEnd) ? _base + *_mark : _end;
+        }
+        /** Returns the first indexed byte at or after the cursor, without moving the cursor. The 
+        marks are offsets from indexBase() up to marksEnd() **/
+        const uint32_t* nextMark()
+        {
+            while((_mark != _marksEnd) && (_base + *_mark < _cursor))
+                ++_mark;
+            return _mark;
+        }
+        const uint32_t* marksEnd() const { return _marksEnd; }
+        const char* indexBase() const { return _base; }
+
+        /** Element count of a container, keyed by the offset of its opening byte from indexBase() **/
+        struct Count
+        {
+            uint32_t offset;
+            uint32_t count;
+        };
+        static const size_t unknownCount = (size_t)-1;
+        /** Returns the element count of the container opened at offset, or unknownCount if the 
+        index does not have it. Containers are looked up in the order of their offsets **/
+        size_t countAt(uint32_t offset)
+        {
+            while((_count != _countsEnd) && (_count->offset < offset))
+                ++_count;
+            return ((_count != _countsEnd) && (_count->offset == offset)) ? _count->count : unknownCount;
+        }
+
+    protected:
+        /** Replaces the exhausted buffer with the next bytes. Returns false at the end of the input **/
+        virtual bool underflow() = 0;
+        /** Makes room for size contiguous bytes keeping the available ones **/
+        virtual bool refill(size_t size) { return false; }
+
+        const char* _cursor;
+        const char* _end;
+
+        /** Offsets of the significant bytes from _base, if the reader has an index **/
+        const char* _base;
+        const uint32_t* _mark;
+        const uint32_t* _marksEnd;
+        /** Element counts ordered by offset, if the index has them **/
+        const Count* _count;
+        const Count* _countsEnd;
+    };
+
+    /* -- READER IMPLEMENTATIONS -- */
+
+    /** Reader over a buffer given by the caller. Nothing is copied **/
+    class BufferReader : public Reader
+    {
+    public:
+        BufferReader(const char* data, size_t size) :
+            _begin(data)
+        {
+            _cursor = data;
+            _end = data + size;
+        }
+        BufferReader(const std::string& data) :
+            _begin(data.data())
+        {
+            _cursor = data.data();
+            _end = data.data() + data.size();
+        }
+
+        /** Returns the count of bytes consumed **/
+        size_t consumed() const { return (size_t)(_cursor - _begin); }
+
+    protected:
+        BufferReader() : _begin(0) {}
+
+        virtual bool underflow() { return false; }
+
+        const char* _begin;
+    };
+
+    /** Reader adapter over a std::istream. Bytes are read in blocks from the stream buffer, and the 
+    ones not consumed are given back to it on release, so the stream can be used again **/
+    class StreamReader : public Reader
+    {
+    public:
+        static const size_t blockSize = 4096;
+
+        StreamReader(std::istream& is) :
+            _is(is),
+            _buffer(_block),
+            _capacity(blockSize),
+            _atEnd(false)
+        {
+            _cursor = _end = _buffer;
+
+            // Takes back the bytes a previous reader of the stream could not put back
+            std::vector<char>* carry = static_cast<std::vector<char>*>(_is.pword(carryIndex()));
+            if(carry != nullptr && !carry->empty())
+            {
+                if(carry->size() > _capacity)
+                {
+                    _heap.resize(carry->size());
+                    _buffer = &_heap[0];
+                    _capacity = carry->size();
+                }
+                memcpy(_buffer, &(*carry)[0], carry->size());
+                _cursor = _buffer;
+                _end = _buffer + carry->size();
+                carry->clear();
+            }
+        }
+        ~StreamReader() { release(); }
+
+        /** Gives back the bytes not consumed to the stream. The stream buffer can only take back the 
+        bytes of its current block, the ones read from earlier blocks are kept with the stream for the 
+        next reader **/
+        void release()
+        {
+            std::streambuf* buffer = _is.rdbuf();
+            size_t unused = available();
+            for(; unused > 0; --unused)
+            {
+                if(std::char_traits<char>::eq_int_type(buffer->sungetc(), std::char_traits<char>::eof()))
+                    break;
+            }
+
+            if(unused > 0)
+            {
+                void*& word = _is.pword(carryIndex());
+                if(word == nullptr)
+                {
+                    word = new std::vector<char>();
+                    _is.register_callback(&StreamReader::carryEvent, carryIndex());
+                }
+                static_cast<std::vector<char>*>(word)->assign(_cursor, _cursor + unused);
+            }
+            _cursor = _end;
+
+            if(_atEnd && unused == 0)
+                _is.setstate(std::ios_base::eofbit);
+        }
+
+    protected:
+        virtual bool underflow()
+        {
+            _cursor = _end = _buffer;
+            return read(_capacity);
+        }
+
+        virtual bool refill(size_t size)
+        {
+            size_t used = available();
+            if(_capacity < size)
+            {
+                std::vector<char> buffer(size);
+                memcpy(&buffer[0], _cursor, used);
+                _heap.swap(buffer);
+                _buffer = &_heap[0];
+                _capacity = size;
+            }
+            else
+                memmove(_buffer, _cursor, used);
+            _cursor = _buffer;
+            _end = _buffer + used;
+
+            while(available() < size)
+            {
+                if(!read(_capacity - available()))
+                    return false;
+            }
+            return true;
+        }
+
+        /** Appends up to size bytes from the current block of the stream buffer. Bytes are only taken 
+        from one block so that the unused ones can be put back **/
+        bool read(size_t size)
+        {
+            std::streambuf* buffer = _is.rdbuf();
+            if(std::char_traits<char>::eq_int_type(buffer->sgetc(), std::char_traits<char>::eof()))
+            {
+                _atEnd = true;
+                return false;
+            }
+
+            std::streamsize count = buffer->in_avail();
+            if(count <= 0)
+                count = 1;
+            if((size_t)count > size)
+                count = (std::streamsize)size;
+
+            count = buffer->sgetn(_buffer + (_end - _buffer), count);
+            _end += count;
+            return count > 0;
+        }
+
+        /** Index of the bytes kept with a stream between readers **/
+        static int carryIndex()
+        {
+            static const int index = std::ios_base::xalloc();
+            return index;
+        }
+
+        static void carryEvent(std::ios_base::event event, std::ios_base& stream, int index)
+        {
+            if(event == std::ios_base::erase_event)
+                delete static_cast<std::vector<char>*>(stream.pword(index));
+            if(event != std::ios_base::imbue_event)
+                stream.pword(index) = nullptr;
+        }
+
+        std::istream& _is;
+        char _block[blockSize];
+        std::vector<char> _heap;
+        char* _buffer;
+        size_t _capacity;
+        bool _atEnd;
+    };
+}
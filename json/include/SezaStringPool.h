@@ -0,0 +1,175 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#if __cplusplus >= 201703L
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Seza
+{
+    /* -- EXCEPTIONS -- */
+
+    /** This exception is thrown when a string view is read by a deserializer without a string pool **/
+    class StringPoolException : public std::exception
+    {
+    public:
+      const char* what() const throw() { return "String views are only read with a string pool!\n"; }
+    };
+
+    /* -- STRING TABLE -- */
+
+    /** Interned strings of a character type. The characters are copied once into blocks and never 
+    moved, so the views handed out are valid until the table is cleared or destroyed **/
+    template<typename Char>
+    class StringTable
+    {
+    public:
+        typedef std::basic_string_view<Char> View;
+
+        StringTable() : 
+            _cursor(0), 
+            _left(0), 
+            _hits(0), 
+            _length(0)
+        {
+        }
+
+        /** Returns the interned copy of value, storing it the first time it is seen **/
+        View intern(View value)
+        {
+            typename std::unordered_set<View>::const_iterator it = _index.find(value);
+            if(it != _index.end())
+            {
+                ++_hits;
+                return *it;
+            }
+
+            Char* data = allocate(value.size() + 1);
+            std::copy(value.begin(), value.end(), data);
+            data[value.size()] = 0; // The views can be used as C strings
+            View interned(data, value.size());
+            _index.insert(interned);
+            _length += value.size();
+            return interned;
+        }
+
+        /** Lookups of strings already interned **/
+        size_t hits() const { return _hits; }
+        /** Count of different strings **/
+        size_t size() const { return _index.size(); }
+        /** Count of characters stored **/
+        size_t length() const { return _length; }
+
+        void clear()
+        {
+            _index.clear();
+            _blocks.clear();
+            _cursor = 0;
+            _left = 0;
+            _hits = 0;
+            _length = 0;
+        }
+
+    protected:
+        /** Long strings get a block of their own, so the current block is not wasted **/
+        Char* allocate(size_t size)
+        {
+            if(size > _left)
+            {
+                if(size > blockSize / 4)
+                {
+                    _blocks.emplace_back(new Char[size]);
+                    return _blocks.back().get();
+                }
+                _blocks.emplace_back(new Char[blockSize]);
+                _cursor = _blocks.back().get();
+                _left = blockSize;
+            }
+            Char* data = _cursor;
+            _cursor += size;
+            _left -= size;
+            return data;
+        }
+
+        static const size_t blockSize = 4096;
+
+        std::unordered_set<View> _index;
+        std::vector<std::unique_ptr<Char[]> > _blocks;
+        Char* _cursor;
+        size_t _left;
+        size_t _hits;
+        size_t _length;
+    };
+
+    /* -- STRING POOL -- */
+
+    /** Pool of interned strings and wide strings. Attached to a deserializer, the std::string_view and 
+    std::wstring_view values read are views into the pool, and each different value is stored once **/
+    class StringPool
+    {
+    public:
+        std::string_view intern(std::string_view value) { return _strings.intern(value); }
+        std::wstring_view intern(std::wstring_view value) { return _wstrings.intern(value); }
+
+        /** Lookups of strings already interned **/
+        size_t hits() const { return _strings.hits() + _wstrings.hits(); }
+        /** Lookups that stored a new string **/
+        size_t misses() const { return size(); }
+        /** Ratio of the lookups of strings already interned **/
+        double hitRate() const 
+        { 
+            size_t lookups = hits() + misses();
+            return lookups ? (double)hits() / lookups : 0.0;
+        }
+        /** Count of different strings **/
+        size_t size() const { return _strings.size() + _wstrings.size(); }
+        /** Count of bytes of the characters stored **/
+        size_t bytes() const { return _strings.length() + _wstrings.length() * sizeof(wchar_t); }
+
+        /** Invalidates all the views handed out **/
+        void clear()
+        {
+            _strings.clear();
+            _wstrings.clear();
+        }
+
+    protected:
+        StringTable<char> _strings;
+        StringTable<wchar_t> _wstrings;
+    };
+}
+
+#endif
@@ -0,0 +1,217 @@
+/* 
+ * Copyright (c) 2013 Soluciones Tecnológicas de Calidad S.L. <info@stcsl.es> and
+ *                    María Ten Rodríguez <m.ten@stcsl.es>
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once;
+
+#include <string.h>
+
+#include <exception>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Seza
+{
+    /* -- EXCEPTIONS -- */
+
+    /** This exception is thrown when a writer over a fixed buffer runs out of space **/
+    class WriterOverflowException : public std::exception
+    {
+    public:
+      const char* what() const throw() { return "Not enough space in the output buffer!\n"; }
+    };
+
+    /* -- WRITER INTERFACE -- */
+
+    /** Contiguous output sink. Bytes are appended to the buffer [_begin, _end) and
+    overflow() is only called when it has not enough room left **/
+    class Writer
+    {
+    public:
+        Writer() : _begin(0), _cursor(0), _end(0) {}
+        virtual ~Writer() {}
+
+        /** Appends a byte **/
+        void put(char c)
+        {
+            if(_cursor == _end)
+                overflow(1);
+            *_cursor++ = c;
+        }
+        /** Appends size bytes **/
+        void write(const char* data, size_t size)
+        {
+            if((size_t)(_end - _cursor) < size)
+                overflow(size);
+            memcpy(_cursor, data, size);
+            _cursor += size;
+        }
+        /** Returns a pointer to at least size writable bytes. The bytes used must be committed **/
+        char* reserve(size_t size)
+        {
+            if((size_t)(_end - _cursor) < size)
+                overflow(size);
+            return _cursor;
+        }
+        /** Commits size bytes written in the pointer returned by reserve **/
+        void commit(size_t size) { _cursor += size; }
+        /** Sends the buffered bytes to the underlying sink **/
+        virtual void flush() {}
+
+        Writer& operator<<(char c) { put(c); return *this; }
+        Writer& operator<<(const char* str) { write(str, strlen(str)); return *this; }
+
+    protected:
+        /** Makes room for at least size bytes after the cursor **/
+        virtual void overflow(size_t size) = 0;
+
+        char* _begin;
+        char* _cursor;
+        char* _end;
+    };
+
+    /* -- WRITER IMPLEMENTATIONS -- */
+
+    /** Writer over a growable string. The string is resized to the bytes written on flush **/
+    class StringWriter : public Writer
+    {
+    public:
+        StringWriter() :
+            _target(&_buffer),
+            _start(0)
+        {
+        }
+        /** Appends to the end of target **/
+        StringWriter(std::string& target) :
+            _target(&target),
+            _start(target.size())
+        {
+            setBuffer(_start);
+        }
+        ~StringWriter() { flush(); }
+
+        /** Returns the bytes written **/
+        const char* data() const { return _begin + _start; }
+        /** Returns the count of bytes written **/
+        size_t size() const { return (size_t)(_cursor - _begin) - _start; }
+        /** Returns a copy of the bytes written **/
+        std::string str() const { return std::string(data(), size()); }
+        /** Discards the bytes written **/
+        void clear() { _cursor = _begin + _start; }
+
+        virtual void flush()
+        {
+            size_t used = (size_t)(_cursor - _begin);
+            _target->resize(used);
+            setBuffer(used);
+        }
+
+    protected:
+        virtual void overflow(size_t size)
+        {
+            size_t used = (size_t)(_cursor - _begin);
+            size_t capacity = 2 * _target->size();
+            if(capacity < used + size)
+                capacity = used + size;
+            if(capacity < 64)
+                capacity = 64;
+            _target->resize(capacity);
+            setBuffer(used);
+        }
+
+        void setBuffer(size_t used)
+        {
+            _begin = &(*_target)[0];
+            _cursor = _begin + used;
+            _end = _begin + _target->size();
+        }
+
+        std::string _buffer;
+        std::string* _target;
+        size_t _start;
+    };
+
+    /** Writer over a fixed buffer given by the caller **/
+    class BufferWriter : public Writer
+    {
+    public:
+        BufferWriter(char* buffer, size_t size)
+        {
+            _begin = _cursor = buffer;
+            _end = buffer + size;
+        }
+
+        /** Returns the bytes written **/
+        const char* data() const { return _begin; }
+        /** Returns the count of bytes written **/
+        size_t size() const { return (size_t)(_cursor - _begin); }
+
+    protected:
+        virtual void overflow(size_t size) { throw WriterOverflowException(); }
+    };
+
+    /** Writer adapter over a std::ostream. Bytes are buffered and written in blocks **/
+    class StreamWriter : public Writer
+    {
+    public:
+        StreamWriter(std::ostream& os, size_t capacity = 4096) :
+            _os(os),
+            _buffer(capacity)
+        {
+            setBuffer();
+        }
+        ~StreamWriter() { flush(); }
+
+        virtual void flush()
+        {
+            if(_cursor != _begin)
+                _os.write(_begin, _cursor - _begin);
+            _cursor = _begin;
+        }
+
+    protected:
+        virtual void overflow(size_t size)
+        {
+            flush();
+            if(_buffer.size() < size)
+            {
+                _buffer.resize(size);
+                setBuffer();
+            }
+        }
+
+        void setBuffer()
+        {
+            _begin = _cursor = &_buffer[0];
+            _end = _begin + _buffer.size();
+        }
+
+        std::ostream& _os;
+        std::vector<char> _buffer;
+    };
+}
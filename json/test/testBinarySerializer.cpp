@@ -0,0 +1,501 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <forward_list>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include <BinarySerializer.h>
+#include <BinaryDeserializer.h>
+#include <SezaPushParser.h>
+
+typedef std::map<std::string, long long> Totals;
+
+struct Sample
+{
+    int id;
+    double ratio;
+    std::string name;
+    std::vector<short> values;
+    Totals totals;
+};
+
+struct Other
+{
+    int id;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Sample, ADD_MEMBER(id, int) ADD_MEMBER(ratio, double) ADD_MEMBER(name, std::string) 
+        ADD_MEMBER(values, std::vector<short>) ADD_MEMBER(totals, Totals))
+    REGISTER_SERIALIZABLE(Other, ADD_MEMBER(id, int))
+}
+
+template<typename T>
+std::string writeBinary(T value)
+{
+    BinarySerializer serializer;
+    Seza::StringWriter writer;
+    serializer.write(writer, value);
+    return writer.str();
+}
+
+template<typename T>
+T readBinary(const std::string& data)
+{
+    BinaryDeserializer deserializer;
+    Seza::BufferReader reader(data);
+    T value = T();
+    deserializer.read(reader, value);
+    EXPECT_EQ(0u, reader.available());
+    return value;
+}
+
+TEST(ValueTest, BinaryTest)
+{
+    EXPECT_EQ(std::string("\x01\x00\x00\x00", 4), writeBinary(1));
+    EXPECT_EQ(std::string("\xFE\xFF", 2), writeBinary((short)-2));
+    EXPECT_EQ(8u, writeBinary(1L).size());
+
+    EXPECT_EQ(true, readBinary<bool>(writeBinary(true)));
+    EXPECT_EQ('z', readBinary<char>(writeBinary('z')));
+    EXPECT_EQ(std::numeric_limits<int>::min(), readBinary<int>(writeBinary(std::numeric_limits<int>::min())));
+    EXPECT_EQ(std::numeric_limits<unsigned long long>::max(), 
+        readBinary<unsigned long long>(writeBinary(std::numeric_limits<unsigned long long>::max())));
+    EXPECT_EQ(-1234567890123LL, readBinary<long long>(writeBinary(-1234567890123LL)));
+    EXPECT_EQ(0.1, readBinary<double>(writeBinary(0.1)));
+    EXPECT_EQ(-2.5f, readBinary<float>(writeBinary(-2.5f)));
+    EXPECT_TRUE(std::signbit(readBinary<double>(writeBinary(-0.0))));
+    EXPECT_TRUE(std::isnan(readBinary<double>(writeBinary(std::numeric_limits<double>::quiet_NaN()))));
+
+    EXPECT_THROW(readBinary<int>(std::string("\x01\x00", 2)), Binary::BinaryException*);
+}
+
+TEST(StringTest, BinaryTest)
+{
+    std::string text("a\0b\"c\\", 6);
+    EXPECT_EQ(std::string("\x06", 1) + text, writeBinary(text));
+    EXPECT_EQ(text, readBinary<std::string>(writeBinary(text)));
+
+    std::string longText(300, 'x');
+    EXPECT_EQ(std::string("\xAC\x02", 2), writeBinary(longText).substr(0, 2));
+    EXPECT_EQ(longText, readBinary<std::string>(writeBinary(longText)));
+
+    std::wstring wide(L"é中");
+    EXPECT_EQ(wide, readBinary<std::wstring>(writeBinary(wide)));
+
+    EXPECT_THROW(readBinary<std::string>(std::string("\x05" "abc", 4)), Binary::BinaryException*);
+
+    // Sizes larger than the input are not allocated up front
+    BinaryDeserializer deserializer;
+    std::string huge = std::string(8, '\xFF') + "\x3F" "abc";
+    std::istringstream narrowInput(huge);
+    EXPECT_THROW(deserializer.read(narrowInput, text), Binary::BinaryException*);
+    std::istringstream wideInput(huge);
+    EXPECT_THROW(deserializer.read(wideInput, wide), Binary::BinaryException*);
+}
+
+TEST(ContainerTest, BinaryTest)
+{
+    std::vector<int> values = { 1, -2, 3 };
+    EXPECT_EQ(13u, writeBinary(values).size());
+    EXPECT_EQ(values, readBinary<std::vector<int> >(writeBinary(values)));
+    EXPECT_TRUE(readBinary<std::vector<int> >(writeBinary(std::vector<int>())).empty());
+
+    std::map<std::string, std::vector<double> > series;
+    series["a"].push_back(1.5);
+    series["b"];
+    EXPECT_TRUE(series == (readBinary<std::map<std::string, std::vector<double> > >(writeBinary(series))));
+
+    std::forward_list<int> list = { 4, 5, 6 };
+    EXPECT_EQ(std::string("\x03", 1), writeBinary(list).substr(0, 1));
+    EXPECT_TRUE(list == readBinary<std::forward_list<int> >(writeBinary(list)));
+
+    // Elements that are not read whole are removed
+    std::string truncated = writeBinary(std::vector<std::string>({ "ab", "cd" }));
+    truncated.resize(truncated.size() - 1);
+    std::vector<std::string> strings;
+    Seza::BufferReader stringsReader(truncated);
+    EXPECT_THROW(BinaryDeserializer().read(stringsReader, strings), Binary::BinaryException*);
+    EXPECT_EQ(std::vector<std::string>(1, "ab"), strings);
+    std::forward_list<std::string> front;
+    Seza::BufferReader frontReader(truncated);
+    EXPECT_THROW(BinaryDeserializer().read(frontReader, front), Binary::BinaryException*);
+    EXPECT_TRUE(std::forward_list<std::string>(1, "ab") == front);
+    std::vector<std::string> statics;
+    Seza::BufferReader staticReader(truncated);
+    EXPECT_THROW(Seza::deserialize<BinaryDeserializer>(staticReader, statics), Binary::BinaryException*);
+    EXPECT_EQ(std::vector<std::string>(1, "ab"), statics);
+
+    int array[4] = { 7, 8, 9, 10 };
+    int copy[4] = { 0, 0, 0, 0 };
+    BinarySerializer serializer;
+    Seza::StringWriter writer;
+    serializer.write(writer, array, 4);
+    std::string data = writer.str();
+    EXPECT_EQ(17u, data.size());
+
+    BinaryDeserializer deserializer;
+    Seza::BufferReader reader(data);
+    EXPECT_EQ(4u, deserializer.read(reader, copy, 4));
+    EXPECT_EQ(10, copy[3]);
+
+    int small[2];
+    Seza::BufferReader overflow(data);
+    EXPECT_THROW(deserializer.read(overflow, small, 2), Binary::BinaryException*);
+}
+
+TEST(SerializableTest, BinaryTest)
+{
+    Sample sample;
+    sample.id = 42;
+    sample.ratio = 0.25;
+    sample.name = "sample";
+    sample.values.push_back(-1);
+    sample.values.push_back(300);
+    sample.totals["x"] = 1LL << 40;
+
+    std::string data = writeBinary(sample);
+    Sample copy = readBinary<Sample>(data);
+    EXPECT_EQ(sample.id, copy.id);
+    EXPECT_EQ(sample.ratio, copy.ratio);
+    EXPECT_EQ(sample.name, copy.name);
+    EXPECT_EQ(sample.values, copy.values);
+    EXPECT_TRUE(sample.totals == copy.totals);
+
+    // Stream adapters
+    BinarySerializer serializer;
+    std::ostringstream os;
+    serializer.write(os, sample);
+    EXPECT_EQ(data, os.str());
+
+    Sample streamed;
+    BinaryDeserializer deserializer;
+    std::istringstream is(os.str());
+    deserializer.read(is, streamed);
+    EXPECT_EQ(sample.name, streamed.name);
+
+    // Class identity
+    EXPECT_THROW(readBinary<Other>(data), Binary::BinaryException*);
+    EXPECT_THROW(readBinary<Sample>(data.substr(0, data.size() - 1)), Binary::BinaryException*);
+}
+
+struct Series
+{
+    std::vector<long long> timestamps;
+    std::vector<int> ids;
+    std::vector<int> readings;
+    std::vector<double> values;
+    std::vector<float> samples;
+    std::vector<unsigned long long> masks;
+    std::vector<double> plain;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Series, ADD_MEMBER_CODEC(timestamps, std::vector<long long>, deltaCodec) 
+        ADD_MEMBER_CODEC(ids, std::vector<int>, varintCodec) ADD_MEMBER_CODEC(readings, std::vector<int>, frameOfReferenceCodec)
+        ADD_MEMBER_CODEC(values, std::vector<double>, xorCodec) ADD_MEMBER_CODEC(samples, std::vector<float>, xorCodec)
+        ADD_MEMBER_CODEC(masks, std::vector<unsigned long long>, frameOfReferenceCodec) ADD_MEMBER(plain, std::vector<double>))
+}
+
+TEST(CodecTest, BinaryTest)
+{
+    Series series;
+    std::mt19937_64 generator(7);
+    long long timestamp = 1700000000000LL;
+    double value = 20.0;
+    for(int i = 0; i < 1000; ++i)
+    {
+        timestamp += 1000 + (long long)(generator() % 10);
+        series.timestamps.push_back(timestamp);
+        series.ids.push_back((int)(generator() % 100) - 50);
+        series.readings.push_back(4000 + (int)(generator() % 200));
+        value += (i % 10 == 0) ? 0.25 : 0.0;
+        series.values.push_back(value);
+        series.samples.push_back((float)(i % 7));
+        series.masks.push_back(generator());
+        series.plain.push_back(value);
+    }
+    series.ids.push_back(std::numeric_limits<int>::min());
+    series.ids.push_back(std::numeric_limits<int>::max());
+    series.timestamps.push_back(std::numeric_limits<long long>::min());
+    series.values.push_back(std::numeric_limits<double>::quiet_NaN());
+    series.values.push_back(-0.0);
+    series.masks.push_back(std::numeric_limits<unsigned long long>::max());
+
+    std::string data = writeBinary(series);
+    Series copy = readBinary<Series>(data);
+    EXPECT_EQ(series.timestamps, copy.timestamps);
+    EXPECT_EQ(series.ids, copy.ids);
+    EXPECT_EQ(series.readings, copy.readings);
+    EXPECT_EQ(series.samples, copy.samples);
+    EXPECT_EQ(series.masks, copy.masks);
+    EXPECT_EQ(series.plain, copy.plain);
+    ASSERT_EQ(series.values.size(), copy.values.size());
+    EXPECT_EQ(0, memcmp(&series.values[0], &copy.values[0], series.values.size() * sizeof(double)));
+
+    // Each codec is smaller than the plain encoding
+    Series plain = series;
+    plain.timestamps.clear();
+    plain.ids.clear();
+    plain.readings.clear();
+    plain.values.clear();
+    plain.samples.clear();
+    plain.masks.clear();
+    size_t base = writeBinary(plain).size();
+
+    Series single = plain;
+    single.timestamps = series.timestamps;
+    EXPECT_LT(writeBinary(single).size() - base, series.timestamps.size() * 3);
+    single = plain;
+    single.readings = series.readings;
+    EXPECT_LT(writeBinary(single).size() - base, series.readings.size() * 2);
+    single = plain;
+    single.values = series.values;
+    EXPECT_LT(writeBinary(single).size() - base, series.values.size());
+
+    Series empty;
+    EXPECT_TRUE(readBinary<Series>(writeBinary(empty)).values.empty());
+
+    // Runs of one byte varints broken by longer ones at every position
+    Series runs;
+    for(int i = 0; i < 1000; ++i)
+    {
+        runs.ids.push_back((i % 17 == 0) ? -100000 * i : i % 60 - 30);
+        runs.timestamps.push_back((i % 23 == 0) ? (long long)i << 40 : i);
+    }
+    Series runsCopy = readBinary<Series>(writeBinary(runs));
+    EXPECT_EQ(runs.ids, runsCopy.ids);
+    EXPECT_EQ(runs.timestamps, runsCopy.timestamps);
+
+    // Counts are not trusted: the numbers grow a block at a time and are restored if they are not read
+    Series constant;
+    constant.readings.assign(300, 4000);
+    std::string counted = writeBinary(constant);
+    size_t position = counted.find(std::string("\xAC\x02", 2) + (char)Seza::frameOfReferenceCodec);
+    ASSERT_NE(std::string::npos, position);
+    counted.replace(position, 2, std::string("\xFF\xFF\xFF\xFF\xFF\x0F", 6));
+
+    Series partial;
+    partial.readings.assign(3, 1);
+    BinaryDeserializer deserializer;
+    Seza::BufferReader countedReader(counted);
+    EXPECT_THROW(deserializer.read(countedReader, partial), Binary::BinaryException*);
+    EXPECT_EQ(std::vector<int>(3, 1), partial.readings);
+
+    // The statically dispatched path uses the codecs too
+    Seza::StringWriter writer;
+    Seza::serialize<BinarySerializer>(writer, series);
+    EXPECT_EQ(data, writer.str());
+
+    Series result;
+    Seza::BufferReader reader(data);
+    Seza::deserialize<BinaryDeserializer>(reader, result);
+    EXPECT_EQ(0u, reader.available());
+    EXPECT_EQ(series.timestamps, result.timestamps);
+    EXPECT_EQ(series.readings, result.readings);
+    EXPECT_EQ(series.plain, result.plain);
+}
+
+struct Vertex
+{
+    float x;
+    float y;
+    int color;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Vertex, ADD_MEMBER(x, float) ADD_MEMBER(y, float) ADD_MEMBER(color, int))
+    REGISTER_TRIVIAL_LAYOUT(Vertex)
+}
+
+TEST(BlockTest, BinaryTest)
+{
+    std::vector<int> values(100000);
+    for(size_t i = 0; i < values.size(); ++i)
+        values[i] = (int)(i * 7919);
+    std::string data = writeBinary(values);
+    EXPECT_EQ(3 + values.size() * sizeof(int), data.size());
+    EXPECT_EQ(0, memcmp(data.data() + 3, &values[0], values.size() * sizeof(int)));
+    EXPECT_EQ(values, readBinary<std::vector<int> >(data));
+
+    // Blocks straddling the buffer of a stream
+    std::vector<int> streamed;
+    BinaryDeserializer deserializer;
+    std::istringstream is(data);
+    deserializer.read(is, streamed);
+    EXPECT_EQ(values, streamed);
+    EXPECT_THROW(readBinary<std::vector<int> >(data.substr(0, data.size() - 1)), Binary::BinaryException*);
+
+    // Elements are appended, the count is not trusted and the vector keeps its size on failure
+    std::vector<int> appended(2, -1);
+    Seza::BufferReader appendedReader(writeBinary(std::vector<int>(3, 5)));
+    deserializer.read(appendedReader, appended);
+    EXPECT_EQ(std::vector<int>({ -1, -1, 5, 5, 5 }), appended);
+
+    std::string huge = std::string(8, '\xFF') + std::string("\x0F" "\x01\x00\x00\x00", 5);
+    Seza::BufferReader hugeReader(huge);
+    EXPECT_THROW(deserializer.read(hugeReader, appended), Binary::BinaryException*);
+    EXPECT_EQ(5u, appended.size());
+    std::istringstream hugeStream(huge);
+    EXPECT_THROW(deserializer.read(hugeStream, appended), Binary::BinaryException*);
+    EXPECT_EQ(5u, appended.size());
+
+    std::array<double, 3> array = {{ 0.5, -1.0, 2.0 }};
+    EXPECT_EQ(1 + 3 * sizeof(double), writeBinary(array).size());
+    EXPECT_TRUE(array == (readBinary<std::array<double, 3> >(writeBinary(array))));
+
+    // Classes declared with a trivial layout
+    std::vector<Vertex> vertices;
+    for(int i = 0; i < 1000; ++i)
+    {
+        Vertex vertex = { (float)i, (float)-i, i * 3 };
+        vertices.push_back(vertex);
+    }
+    data = writeBinary(vertices);
+    EXPECT_EQ(2 + vertices.size() * sizeof(Vertex), data.size());
+    std::vector<Vertex> copy = readBinary<std::vector<Vertex> >(data);
+    ASSERT_EQ(vertices.size(), copy.size());
+    EXPECT_EQ(0, memcmp(&vertices[0], &copy[0], vertices.size() * sizeof(Vertex)));
+
+    // Single objects keep the member encoding
+    EXPECT_EQ(2997, readBinary<Vertex>(writeBinary(vertices[999])).color);
+}
+
+/** Counts the copies of its instances **/
+struct Tracked
+{
+    Tracked() : id(0) {}
+    Tracked(const Tracked& other) : id(other.id), values(other.values) { ++copies; }
+    Tracked(Tracked&& other) = default;
+    Tracked& operator=(const Tracked& other) 
+    { 
+        id = other.id;
+        values = other.values;
+        ++copies;
+        return *this; 
+    }
+    Tracked& operator=(Tracked&& other) = default;
+    bool operator<(const Tracked& other) const { return id < other.id; }
+
+    int id;
+    std::vector<int> values;
+
+    static int copies;
+};
+
+int Tracked::copies = 0;
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Tracked, ADD_MEMBER(id, int) ADD_MEMBER(values, std::vector<int>))
+}
+
+TEST(ReserveTest, BinaryTest)
+{
+    std::vector<Tracked> list(1000);
+    std::unordered_map<std::string, Tracked> map;
+    std::set<Tracked> set;
+    for(int i = 0; i < 1000; ++i)
+    {
+        list[i].id = i;
+        list[i].values.assign(10, i);
+        map[std::to_string(i)] = list[i];
+        set.insert(list[i]);
+    }
+    std::string listData = writeBinary(list);
+    std::string mapData = writeBinary(map);
+    std::string setData = writeBinary(set);
+
+    // Elements are read in place or moved, and the containers are reserved from the counts
+    Tracked::copies = 0;
+    std::vector<Tracked> listCopy = readBinary<std::vector<Tracked> >(listData);
+    std::unordered_map<std::string, Tracked> mapCopy = readBinary<std::unordered_map<std::string, Tracked> >(mapData);
+    std::set<Tracked> setCopy = readBinary<std::set<Tracked> >(setData);
+    EXPECT_EQ(0, Tracked::copies);
+
+    ASSERT_EQ(list.size(), listCopy.size());
+    EXPECT_EQ(list.size(), listCopy.capacity());
+    EXPECT_EQ(list[999].values, listCopy[999].values);
+    ASSERT_EQ(map.size(), mapCopy.size());
+    EXPECT_EQ(list[5].values, mapCopy["5"].values);
+    std::unordered_map<std::string, Tracked> reserved;
+    reserved.reserve(map.size());
+    EXPECT_EQ(reserved.bucket_count(), mapCopy.bucket_count());
+    EXPECT_EQ(set.size(), setCopy.size());
+
+    std::vector<std::string> strings(100, "text");
+    EXPECT_EQ(strings.size(), readBinary<std::vector<std::string> >(writeBinary(strings)).capacity());
+
+    // Counts larger than the input are not trusted
+    std::string truncated = listData.substr(0, 10);
+    EXPECT_ANY_THROW(readBinary<std::vector<Tracked> >(truncated));
+
+    std::vector<bool> bits = { true, false, true };
+    EXPECT_EQ(bits, readBinary<std::vector<bool> >(writeBinary(bits)));
+}
+
+TEST(PushParserTest, BinaryTest)
+{
+    std::vector<Sample> samples(50);
+    for(size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i].id = (int)i;
+        samples[i].ratio = 0.5 * i;
+        samples[i].name = "sample " + std::to_string(i);
+        samples[i].values.assign(i % 7, (short)i);
+        samples[i].totals["x"] = (long long)i << 40;
+    }
+    std::string data = writeBinary(samples);
+
+    // Fixed size values and sizes are split between chunks
+    size_t chunks[] = { 1, 5, 1000 };
+    for(size_t chunk : chunks)
+    {
+        std::vector<Sample> result;
+        BinaryDeserializer deserializer;
+        Seza::PushParser parser(deserializer, result);
+        bool done = false;
+        for(size_t i = 0; i < data.size(); i += chunk)
+            done = parser.feed(data.substr(i, chunk));
+        EXPECT_TRUE(done);
+        parser.finish();
+        EXPECT_EQ(data, writeBinary(result));
+    }
+
+    std::vector<Sample> truncated;
+    BinaryDeserializer deserializer;
+    Seza::PushParser parser(deserializer, truncated);
+    parser.feed(data.substr(0, data.size() - 1));
+    EXPECT_THROW(parser.finish(), Binary::BinaryException*);
+}
+
+TEST(RangeTest, BinaryTest)
+{
+    std::vector<int> numbers = { 5, -3, 1 << 20 };
+    std::string expected = writeBinary(numbers);
+    EXPECT_EQ(expected, writeBinary(Seza::makeRange(numbers)));
+
+    // The count is written first, so it must be given for input iterators and generators
+    std::istringstream input("5 -3 1048576");
+    EXPECT_EQ(expected, writeBinary(Seza::makeRange(std::istream_iterator<int>(input), std::istream_iterator<int>(), 3)));
+    std::istringstream unsized("5 -3 1048576");
+    EXPECT_THROW(writeBinary(Seza::makeRange(std::istream_iterator<int>(unsized), std::istream_iterator<int>())), Seza::UnknownSizeException);
+
+    size_t next = 0;
+    auto generator = [&](int& number)
+    {
+        if(next == numbers.size())
+            return false;
+        number = numbers[next++];
+        return true;
+    };
+    EXPECT_EQ(expected, writeBinary(Seza::makeGenerator<int>(generator, numbers.size())));
+    EXPECT_THROW(writeBinary(Seza::makeGenerator<int>(generator)), Seza::UnknownSizeException);
+    EXPECT_EQ(numbers, readBinary<std::vector<int> >(expected));
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <FlatSerializer.h>
+#include <FlatAccessors.h>
+#include <SezaMappedFile.h>
+
+typedef std::map<std::string, int> Index;
+
+struct Entry
+{
+    std::string key;
+    double weight;
+};
+
+struct Lookup
+{
+    int version;
+    bool enabled;
+    long double precise;
+    std::string name;
+    std::vector<int> values;
+    std::vector<std::string> tags;
+    std::vector<Entry> entries;
+    Index index;
+    Entry main;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Entry, ADD_MEMBER(key, std::string) ADD_MEMBER(weight, double))
+    REGISTER_SERIALIZABLE(Lookup, ADD_MEMBER(version, int) ADD_MEMBER(enabled, bool) ADD_MEMBER(precise, long double)
+        ADD_MEMBER(name, std::string) ADD_MEMBER(values, std::vector<int>) ADD_MEMBER(tags, std::vector<std::string>)
+        ADD_MEMBER(entries, std::vector<Entry>) ADD_MEMBER(index, Index) ADD_MEMBER(main, Entry))
+}
+
+template<typename T>
+std::string writeFlat(T value)
+{
+    FlatSerializer serializer;
+    Seza::StringWriter writer;
+    serializer.write(writer, value);
+    return writer.str();
+}
+
+Lookup makeLookup()
+{
+    Lookup lookup;
+    lookup.version = 3;
+    lookup.enabled = true;
+    lookup.precise = 1.25L;
+    lookup.name = "lookup";
+    for(int i = 0; i < 100; ++i)
+        lookup.values.push_back(i * i);
+    lookup.tags.push_back("a");
+    lookup.tags.push_back("");
+    lookup.tags.push_back("ccc");
+    Entry entry = { "first", 0.5 };
+    lookup.entries.push_back(entry);
+    for(int i = 0; i < 50; ++i)
+        lookup.index["key" + std::to_string(i)] = i;
+    lookup.main.key = "main";
+    lookup.main.weight = -2.0;
+    return lookup;
+}
+
+TEST(FlatTest, ScalarTest)
+{
+    std::string data = writeFlat(42);
+    EXPECT_EQ(Flat::headerSize, data.size());
+    EXPECT_EQ(42, Flat::root<int>(data));
+    EXPECT_EQ(2.5L, Flat::root<long double>(writeFlat(2.5L)));
+    EXPECT_EQ("text", Flat::root<std::string>(writeFlat(std::string("text"))));
+    EXPECT_STREQ(L"wide", Flat::root<std::wstring>(writeFlat(std::wstring(L"wide"))).c_str());
+
+    EXPECT_THROW(Flat::root<int>(data.substr(0, 8)), Flat::FlatException*);
+    EXPECT_THROW(Flat::root<Entry>(data), Flat::FlatException*);
+}
+
+TEST(FlatTest, TableTest)
+{
+    Lookup lookup = makeLookup();
+    std::string data = writeFlat(lookup);
+    EXPECT_THROW(Flat::root<Entry>(data), Flat::FlatException*);
+
+    Flat::Table<Lookup> table = Flat::root<Lookup>(data);
+    EXPECT_EQ(9u, table.size());
+    EXPECT_EQ(3, (table.get<int, &Lookup::version>()));
+    EXPECT_TRUE(table.get<&Lookup::enabled>());
+    EXPECT_EQ(1.25L, table.get<&Lookup::precise>());
+    EXPECT_EQ("lookup", table.get<&Lookup::name>());
+    EXPECT_STREQ("lookup", table.get<&Lookup::name>().c_str());
+
+    // Scalars are read in place
+    Flat::Vector<int> values = table.get<&Lookup::values>();
+    ASSERT_EQ(100u, values.size());
+    EXPECT_EQ(81, values[9]);
+    EXPECT_TRUE(values.data() >= (const int*)data.data() && values.end() <= (const int*)(data.data() + data.size()));
+    EXPECT_EQ(0u, (uintptr_t)values.data() % alignof(int));
+    EXPECT_THROW(values.at(100), Flat::FlatException*);
+
+    Flat::Vector<std::string> tags = table.get<&Lookup::tags>();
+    ASSERT_EQ(3u, tags.size());
+    EXPECT_EQ("a", tags[0]);
+    EXPECT_TRUE(tags[1].empty());
+    EXPECT_EQ("ccc", tags[2]);
+
+    EXPECT_EQ("first", table.get<&Lookup::entries>()[0].get<&Entry::key>());
+    EXPECT_EQ(0.5, table.get<&Lookup::entries>()[0].get<&Entry::weight>());
+    EXPECT_EQ(-2.0, table.get<&Lookup::main>().get<&Entry::weight>());
+
+    Flat::Map<std::string, int> index = table.get<&Lookup::index>();
+    EXPECT_EQ(50u, index.size());
+    EXPECT_EQ(17, index.at("key17"));
+    EXPECT_EQ(0, index.at("key0"));
+    EXPECT_FALSE(index.contains("key50"));
+    EXPECT_EQ("key0", index[0].first());
+    EXPECT_THROW(index.at("missing"), Flat::FlatException*);
+}
+
+TEST(FlatTest, VerifyTest)
+{
+    std::string data = writeFlat(makeLookup());
+    EXPECT_NO_THROW(Flat::verify<Lookup>(data));
+    Flat::verify<std::string>(writeFlat(std::string("text")));
+    Flat::verify<long double>(writeFlat(2.5L));
+    EXPECT_THROW(Flat::verify<Entry>(data), Flat::FlatException*);
+
+    // Truncated buffers pass the header check of root, but not the verification
+    std::string truncated = data.substr(0, Flat::slotOffset(data.data() + Flat::rootSlot) + Flat::slotSize);
+    EXPECT_NO_THROW(Flat::root<Lookup>(truncated));
+    EXPECT_THROW(Flat::verify<Lookup>(truncated), Flat::FlatException*);
+
+    // Corrupt offsets and counts anywhere are rejected, or stay inside the buffer
+    size_t rejected = 0;
+    for(size_t i = Flat::headerSize; i + 4 <= data.size(); i += 4)
+    {
+        std::string corrupt = data;
+        Flat::storeUint32(&corrupt[i], 0x7FFFFFF0);
+        try
+        {
+            Flat::verify<Lookup>(corrupt);
+        }
+        catch(Flat::FlatException* e)
+        {
+            delete e;
+            ++rejected;
+        }
+    }
+    EXPECT_LT(0u, rejected);
+
+    // Slots may share their target, each one is checked on its own
+    std::string nested = writeFlat(std::vector<std::vector<std::string> >(2, std::vector<std::string>(1, "x")));
+    const char* outer = nested.data() + Flat::slotOffset(nested.data() + Flat::rootSlot);
+    std::string shared = nested;
+    std::memcpy(&shared[outer - nested.data() + Flat::slotSize], outer, Flat::slotSize);
+    Flat::verify<std::vector<std::vector<std::string> > >(shared);
+}
+
+TEST(FlatTest, MappedFileTest)
+{
+    std::string path = "flatMappedFile.bin";
+    {
+        std::ofstream file(path.c_str(), std::ios::binary);
+        FlatSerializer serializer;
+        serializer.write(file, makeLookup());
+    }
+
+    {
+        Seza::MappedFileReader file(path);
+        Flat::verify<Lookup>(file.data(), file.size());
+        Flat::Table<Lookup> table = Flat::root<Lookup>(file.data(), file.size());
+        EXPECT_EQ("main", table.get<&Lookup::main>().get<&Entry::key>());
+        EXPECT_EQ(49, table.get<&Lookup::index>().at("key49"));
+    }
+    std::remove(path.c_str());
+}
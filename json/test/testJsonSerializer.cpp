@@ -1,8 +1,118 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
 #include <JsonDefinitions.h>
 #include <JsonSerializer.h>
 #include <JsonDeserializer.h>
+#include <JsonDocument.h>
+#include <JsonLines.h>
+#include <JsonStructuralIndex.h>
+#include <SezaMappedFile.h>
+#include <SezaPushParser.h>
+
+struct Point
+{
+    int x;
+    int y;
+    std::string label;
+    std::vector<int> values;
+};
+
+struct Empty
+{
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Point, ADD_MEMBER(x, int) ADD_MEMBER(y, int) ADD_MEMBER(label, std::string) ADD_MEMBER(values, std::vector<int>))
+    REGISTER_SERIALIZABLE(Empty, NO_MEMBERS)
+}
+
+typedef std::map<std::string, std::vector<int> > Group;
+typedef std::unordered_map<std::string, Group> Groups;
+
+struct Catalog
+{
+    std::string name;
+    Groups groups;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Catalog, ADD_MEMBER(name, std::string) ADD_MEMBER(groups, Groups))
+}
+
+/** Tree nested as deep as its input **/
+struct Tree
+{
+    std::vector<Tree> children;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Tree, ADD_MEMBER(children, std::vector<Tree>))
+}
+
+#if __cplusplus >= 201703L
+typedef std::pmr::vector<std::pmr::string> Tags;
+typedef std::pmr::map<std::pmr::string, std::pmr::vector<int> > Counts;
+
+/** Message whose contents are allocated in a memory resource **/
+struct Message
+{
+    typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
+    explicit Message(const allocator_type& allocator = allocator_type()) : 
+        name(allocator), 
+        tags(allocator), 
+        counts(allocator)
+    {
+    }
+
+    std::pmr::string name;
+    Tags tags;
+    Counts counts;
+};
+
+typedef std::map<std::string_view, int> Metrics;
+
+/** Record whose strings are interned in a string pool **/
+struct Record
+{
+    std::string_view status;
+    std::string_view host;
+    Metrics metrics;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Message, ADD_MEMBER(name, std::pmr::string) ADD_MEMBER(tags, Tags) ADD_MEMBER(counts, Counts))
+    REGISTER_SERIALIZABLE(Record, ADD_MEMBER(status, std::string_view) ADD_MEMBER(host, std::string_view) ADD_MEMBER(metrics, Metrics))
+}
+#endif
+
+/** Count of the allocations of the test program. Threads of other tests allocate too **/
+static std::atomic<size_t> allocations(0);
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    void* p = malloc(size ? size : 1);
+    if(p == 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t size) noexcept { free(p); }
 
 TEST(NullTest, StreamJSONTest)
 {
@@ -10,6 +120,1048 @@ TEST(NullTest, StreamJSONTest)
 EXPECT_EQ(2 + 2, 4);
 }
 
+TEST(SerializableTest, MembersTable)
+{
+    Point a, b;
+    Seza::SerializableClass<Point> first(a), second(b);
+
+    EXPECT_EQ(&Seza::SerializableClass<Point>::getMembers(), &Seza::SerializableClass<Point>::getMembers());
+    EXPECT_EQ(4u, first.membersCount());
+    EXPECT_EQ(0u, Seza::SerializableClass<Empty>::getMembers().size());
+
+    first.begin();
+    second.begin();
+    EXPECT_STREQ("x", first.getElemName());
+    EXPECT_STREQ("x", second.getElemName());
+}
+
+/** Member table that falls back to the linear search **/
+struct LinearTable : public Seza::MemberTable
+{
+    LinearTable(const Seza::MemberDescriptor* members) : Seza::MemberTable(members) { _slots.clear(); }
+};
+
+TEST(SerializableTest, MemberLookup)
+{
+    const Seza::MemberTable& members = Seza::SerializableClass<Point>::getMembers();
+
+    EXPECT_STREQ("label", members.find("label", 5)->name);
+    EXPECT_STREQ("y", members.find("y", 1)->name);
+    EXPECT_TRUE(members.find("labels", 6) == NULL);
+    EXPECT_TRUE(members.find("z", 1) == NULL);
+
+    // Wide classes
+    std::vector<std::string> names;
+    std::vector<Seza::MemberDescriptor> descriptors;
+    for(int i = 0; i < 40; ++i)
+        names.push_back("member" + std::to_string(i));
+    for(size_t i = 0; i < names.size(); ++i)
+    {
+        Seza::MemberDescriptor descriptor = Seza::MemberDescriptor();
+        descriptor.name = names[i].c_str();
+        descriptor.nameLength = names[i].size();
+        descriptors.push_back(descriptor);
+    }
+    descriptors.push_back(Seza::MemberDescriptor());
+
+    Seza::MemberTable wide(&descriptors[0]);
+    EXPECT_EQ(40u, wide.size());
+    for(size_t i = 0; i < names.size(); ++i)
+        EXPECT_EQ(&descriptors[i], wide.find(names[i].data(), names[i].size()));
+    EXPECT_TRUE(wide.find("member40", 8) == NULL);
+
+    // Tables without a perfect hash are searched linearly
+    LinearTable linear(&descriptors[0]);
+    for(size_t i = 0; i < names.size(); ++i)
+        EXPECT_EQ(&descriptors[i], linear.find(names[i].data(), names[i].size()));
+    EXPECT_TRUE(linear.find("member40", 8) == NULL);
+
+    // Wide names out of ASCII do not alias narrow names: (char)L'\u0178' is 'x'
+    Point point = { 0, 0, "", {} };
+    JsonDeserializer deserializer;
+    std::wistringstream is(L"{\"_className_\":\"Point\",\"\u0178\":5}");
+    EXPECT_ANY_THROW(deserializer.read(is, point));
+    EXPECT_EQ(0, point.x);
+}
+
+TEST(SerializableTest, StreamJSONTest)
+{
+    Point point = { 1, -2, "origin", { 3, 4, 5 } };
+    JsonSerializer serializer;
+    std::ostringstream os;
+    serializer.write(os, point);
+
+    EXPECT_EQ("{\"_className_\":\"Point\",\"x\":1,\"y\":-2,\"label\":\"origin\",\"values\":[3,4,5]}", os.str());
+
+    Point result = { 0, 0, "", {} };
+    JsonDeserializer deserializer;
+    std::istringstream is(os.str());
+    static_cast<Seza::Deserializer&>(deserializer).read(is, result);
+
+    EXPECT_EQ(1, result.x);
+    EXPECT_EQ(-2, result.y);
+    EXPECT_EQ("origin", result.label);
+    EXPECT_EQ(point.values, result.values);
+
+    std::istringstream unknown("{\"_className_\":\"Point\",\"z\":1}");
+    EXPECT_ANY_THROW(static_cast<Seza::Deserializer&>(deserializer).read(unknown, result));
+}
+
+TEST(WriterTest, StringWriterJSONTest)
+{
+    Point point = { 7, 8, "p", { 1 } };
+    JsonSerializer serializer;
+
+    std::string output = "prefix";
+    {
+        Seza::StringWriter writer(output);
+        serializer.write(writer, point);
+        serializer.write(writer, point.values);
+    }
+    EXPECT_EQ("prefix{\"_className_\":\"Point\",\"x\":7,\"y\":8,\"label\":\"p\",\"values\":[1]}[1]", output);
+
+    Seza::StringWriter writer;
+    std::vector<int> values(1000, 123456);
+    serializer.write(writer, values);
+    EXPECT_EQ(1000u * 7u + 1u, writer.size());
+    EXPECT_EQ('[', writer.str()[0]);
+}
+
+TEST(WriterTest, AllocationJSONTest)
+{
+    Catalog catalog;
+    catalog.name = "a catalog with a name longer than the small strings";
+    for(int i = 0; i < 20; ++i)
+    {
+        Group& group = catalog.groups["a group with a long key " + std::to_string(i)];
+        for(int j = 0; j < 20; ++j)
+            group["an item with a long key " + std::to_string(j)].assign(10, i * j);
+    }
+
+    JsonSerializer serializer;
+    Seza::StringWriter expected; // The member tables are built on first use
+    serializer.write(expected, catalog);
+    serializer.write(expected, catalog.groups);
+    serializer.write(expected, catalog);
+
+    // Serializing a nested map of vectors allocates nothing besides the output
+    std::vector<char> buffer(1 << 20);
+    size_t before = allocations;
+    Seza::BufferWriter writer(&buffer[0], buffer.size());
+    serializer.write(writer, catalog);
+    serializer.write(writer, catalog.groups);
+    Seza::serialize<JsonSerializer>(writer, catalog);
+    EXPECT_EQ(before, allocations);
+
+    EXPECT_EQ(expected.str(), std::string(writer.data(), writer.size()));
+    EXPECT_EQ(0u, expected.str().find("{\"_className_\":\"Catalog\",\"name\":\"a catalog with a name"));
+
+    // Container names are returned as strings, built only when they are asked for
+    Seza::SerializableSTLMap<Groups, std::string, Group> groups(catalog.groups, "std::unordered_map");
+    const std::string& name = groups.getClassName();
+    EXPECT_EQ("std::unordered_map", name);
+
+    // Constant pairs are written in place, by both paths
+    const std::pair<const std::string, int> entry("key", 1);
+    Seza::StringWriter pairs;
+    serializer.write(pairs, entry);
+    Seza::serialize<JsonSerializer>(pairs, entry);
+    EXPECT_EQ("[\"key\",1][\"key\",1]", pairs.str());
+}
+
+TEST(WriterTest, BufferWriterJSONTest)
+{
+    JsonSerializer serializer;
+    std::vector<int> values(3, 42);
+
+    char buffer[16];
+    Seza::BufferWriter writer(buffer, sizeof(buffer));
+    serializer.write(writer, values);
+    EXPECT_EQ("[42,42,42]", std::string(writer.data(), writer.size()));
+
+    char small[4];
+    Seza::BufferWriter overflow(small, sizeof(small));
+    EXPECT_THROW(serializer.write(overflow, values), Seza::WriterOverflowException);
+}
+
+TEST(ReaderTest, BufferReaderJSONTest)
+{
+    std::string json = "{\"_className_\":\"Point\", \"x\": 5, \"y\":6,\"label\":\"a \\\"b\\\"\",\"values\":[1, 2]} [7,8]";
+    JsonDeserializer deserializer;
+    Point point = { 0, 0, "", {} };
+    std::vector<int> values;
+
+    Seza::BufferReader reader(json.data(), json.size());
+    deserializer.read(reader, point);
+    deserializer.read(reader, values);
+
+    EXPECT_EQ(5, point.x);
+    EXPECT_EQ(6, point.y);
+    EXPECT_EQ("a \"b\"", point.label);
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), point.values);
+    EXPECT_EQ(std::vector<int>({ 7, 8 }), values);
+    EXPECT_EQ(json.size(), reader.consumed());
+
+    std::string truncated = "[1,2";
+    Seza::BufferReader end(truncated);
+    EXPECT_THROW(deserializer.read(end, values), JsonException*);
+}
+
+TEST(ReaderTest, StructuralIndexTest)
+{
+    std::string json = "{ \"a\\\"[\" : [ 12 ,true,\"\\\\\"] }";
+    JSON::StructuralIndex index;
+    ASSERT_TRUE(index.build(json.data(), json.size()));
+
+    std::string marks;
+    for(size_t i = 0; i < index.size(); ++i)
+        marks += json[index[i]];
+    EXPECT_EQ("{\":[1,t,\"]}", marks);
+
+    std::string unterminated = "[\"abc\\\"]";
+    EXPECT_FALSE(index.build(unterminated.data(), unterminated.size()));
+}
+
+TEST(ReaderTest, IndexedReaderJSONTest)
+{
+    std::string json = "{\n  \"_className_\" : \"Point\",\n  \"x\" : 5,\n  \"y\" : -6,\n"
+        "  \"label\" : \"{ \\\"x\\\" : [1, 2] }\",\n  \"values\" : [ 1 ,\n 2 ,  3 ]\n}\n";
+    for(int i = 0; i < 100; ++i)
+        json += "  [ " + std::to_string(i) + " , " + std::to_string(i + 1) + " ]\n";
+
+    JSON::IndexedReader reader(json);
+    EXPECT_TRUE(reader.indexed());
+
+    JsonDeserializer deserializer;
+    Point point = { 0, 0, "", {} };
+    deserializer.read(reader, point);
+    EXPECT_EQ(5, point.x);
+    EXPECT_EQ(-6, point.y);
+    EXPECT_EQ("{ \"x\" : [1, 2] }", point.label);
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), point.values);
+
+    std::vector<int> values;
+    for(int i = 0; i < 100; ++i)
+    {
+        values.clear();
+        deserializer.read(reader, values);
+        EXPECT_EQ(std::vector<int>({ i, i + 1 }), values);
+    }
+
+    std::string invalid = "[1 x]";
+    JSON::IndexedReader invalidReader(invalid);
+    EXPECT_THROW(deserializer.read(invalidReader, values), JsonException*);
+}
+
+TEST(ReaderTest, ReserveJSONTest)
+{
+    // The structural index gives the count of elements of the arrays and the length of the strings
+    std::string strings = "[[\"a,b\", \"]\", \"c\"], [], [\"[d]\"]]";
+    std::string objects = "[[{\"_className_\":\"Point\",\"x\":1,\"values\":[1,2]}, {\"_className_\":\"Point\",\"x\":2}], []]";
+    std::string text = "\"" + std::string(100, 'x') + "\\n\"";
+    std::string invalid = "[1, 2";
+
+    JsonDeserializer deserializer;
+    std::vector<std::vector<std::string> > nested;
+    JSON::IndexedReader reader(strings);
+    deserializer.read(reader, nested);
+    ASSERT_EQ(3u, nested.size());
+    EXPECT_EQ(3u, nested.capacity());
+    EXPECT_EQ(std::vector<std::string>({ "a,b", "]", "c" }), nested[0]);
+    EXPECT_EQ(3u, nested[0].capacity());
+    EXPECT_TRUE(nested[1].empty());
+    EXPECT_EQ(std::vector<std::string>({ "[d]" }), nested[2]);
+
+    // Each array is counted once, when the index is built
+    std::vector<std::vector<std::vector<int> > > deep;
+    std::string deepText = "[[[1, 2, 3]], [[4], [5, 6, 7]]]";
+    JSON::IndexedReader nestedReader(deepText);
+    const Seza::Reader::Count* counts = nestedReader.index().countsBegin();
+    ASSERT_EQ(6, nestedReader.index().countsEnd() - counts);
+    EXPECT_EQ(2u, counts[0].count);
+    EXPECT_EQ(1u, counts[1].count);
+    EXPECT_EQ(3u, counts[2].count);
+    EXPECT_EQ(2u, counts[3].count);
+    EXPECT_EQ(1u, counts[4].count);
+    EXPECT_EQ(3u, counts[5].count);
+    deserializer.read(nestedReader, deep);
+    ASSERT_EQ(2u, deep.size());
+    EXPECT_EQ(2u, deep.capacity());
+    EXPECT_EQ(3u, deep[0][0].capacity());
+    EXPECT_EQ(2u, deep[1].capacity());
+    EXPECT_EQ(3u, deep[1][1].capacity());
+
+    std::vector<std::vector<Point> > points;
+    JSON::IndexedReader objectsReader(objects);
+    deserializer.read(objectsReader, points);
+    ASSERT_EQ(2u, points.size());
+    EXPECT_EQ(2u, points.capacity());
+    ASSERT_EQ(2u, points[0].size());
+    EXPECT_EQ(2u, points[0].capacity());
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), points[0][0].values);
+    EXPECT_EQ(2, points[0][1].x);
+
+    std::string value;
+    JSON::IndexedReader textReader(text);
+    deserializer.read(textReader, value);
+    EXPECT_EQ(std::string(100, 'x') + "\n", value);
+    EXPECT_GE(value.capacity(), 102u);
+
+    // Arrays not terminated are not reserved
+    std::vector<int> values;
+    JSON::IndexedReader invalidReader(invalid);
+    EXPECT_THROW(deserializer.read(invalidReader, values), JsonException*);
+}
+
+TEST(DocumentTest, NavigationJSONTest)
+{
+    std::string json = "{ \"skipped\": { \"deep\": [[1, {\"a\": \"]}\"}], \"x\"] },\n"
+        "  \"a\": { \"b\": [10, 20.5, \"text\", null, true, [1, 2], {}] },\n"
+        "  \"esc\\u0061ped\": 1,\n"
+        "  \"point\": {\"_className_\":\"Point\",\"x\":1,\"y\":2,\"label\":\"p\",\"values\":[]} }";
+
+    JSON::Document document(json);
+    JSON::Value root = document.root();
+
+    EXPECT_TRUE(root.isObject());
+    EXPECT_EQ(4u, root.size());
+    EXPECT_EQ(7u, root["a"]["b"].size());
+    EXPECT_EQ(10, root["a"]["b"][0].as<int>());
+    EXPECT_EQ(20.5, root["a"]["b"][1].as<double>());
+    EXPECT_EQ("text", root["a"]["b"][2].as<std::string>());
+    EXPECT_TRUE(root["a"]["b"][3].isNull());
+    EXPECT_TRUE(root["a"]["b"][4].as<bool>());
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), root["a"]["b"][5].as<std::vector<int> >());
+    EXPECT_EQ(0u, root["a"]["b"][6].size());
+    EXPECT_EQ("[1, 2]", std::string(root["a"]["b"][5].data(), root["a"]["b"][5].length()));
+    EXPECT_EQ(1, root["escaped"].as<int>());
+
+    Point point = root["point"].as<Point>();
+    EXPECT_EQ(2, point.y);
+    EXPECT_EQ("p", point.label);
+
+    EXPECT_FALSE(root.find("missing").exists());
+    EXPECT_FALSE(root["a"]["b"].at(7).exists());
+    EXPECT_FALSE(root.find("missing").find("more").exists());
+    EXPECT_THROW(root["missing"], JsonException*);
+    EXPECT_THROW(root["a"][0], JsonException*);
+    EXPECT_THROW(root.find("missing").length(), JsonException*);
+    EXPECT_THROW(JSON::Value().length(), JsonException*);
+    EXPECT_FALSE((std::is_constructible<JSON::Document, std::string>::value));
+}
+
+TEST(ReaderTest, StreamReaderJSONTest)
+{
+    JsonSerializer serializer;
+    JsonDeserializer deserializer;
+
+    // Values larger than a block and values after them in the same stream
+    std::vector<double> values;
+    for(int i = 0; i < 5000; ++i)
+        values.push_back(i / 7.0);
+    std::string label(10000, 'x');
+
+    std::ostringstream os;
+    serializer.write(os, values);
+    os << ' ';
+    serializer.write(os, label);
+    os << " 42";
+
+    std::vector<double> result;
+    std::string resultLabel;
+    int last = 0;
+    std::istringstream is(os.str());
+    deserializer.read(is, result);
+    deserializer.read(is, resultLabel);
+    deserializer.read(is, last);
+
+    EXPECT_EQ(values, result);
+    EXPECT_EQ(label, resultLabel);
+    EXPECT_EQ(42, last);
+}
+
+/** Stream buffer that delivers its input in blocks of 16 bytes, like a pipe. Bytes can only be put 
+back within the current block **/
+class BlockBuffer : public std::streambuf
+{
+public:
+    BlockBuffer(const std::string& data) : _data(data), _position(0) {}
+
+protected:
+    virtual int_type underflow()
+    {
+        if(_position == _data.size())
+            return traits_type::eof();
+        size_t size = std::min<size_t>(16, _data.size() - _position);
+        std::copy(_data.data() + _position, _data.data() + _position + size, _block);
+        _position += size;
+        setg(_block, _block, _block + size);
+        return traits_type::to_int_type(_block[0]);
+    }
+
+    std::string _data;
+    size_t _position;
+    char _block[16];
+};
+
+TEST(ReaderTest, BlockStreamJSONTest)
+{
+    JsonDeserializer deserializer;
+
+    // Bytes read ahead of a value across blocks are kept for the next read of the stream
+    for(size_t padding = 0; padding < 16; ++padding)
+    {
+        std::string input(padding, ' ');
+        for(int i = 0; i < 20; ++i)
+            input += "\"v" + std::to_string(i) + "\\n\"  " + std::to_string(7 + i) + " ";
+
+        BlockBuffer buffer(input);
+        std::istream is(&buffer);
+        for(int i = 0; i < 20; ++i)
+        {
+            std::string text;
+            int number = 0;
+            deserializer.read(is, text);
+            deserializer.read(is, number);
+            EXPECT_EQ("v" + std::to_string(i) + "\n", text);
+            EXPECT_EQ(7 + i, number);
+        }
+    }
+}
+
+TEST(ReaderTest, MappedFileJSONTest)
+{
+    std::vector<long long> values;
+    for(long long i = 0; i < 10000; ++i)
+        values.push_back(i * i * i);
+
+    const char* path = "testMappedFile.json";
+    {
+        std::ofstream os(path);
+        JsonSerializer serializer;
+        serializer.write(os, values);
+    }
+
+    std::vector<long long> result;
+    {
+        Seza::MappedFileReader reader(path);
+        JsonDeserializer deserializer;
+        deserializer.read(reader, result);
+        EXPECT_EQ(reader.size(), reader.consumed());
+    }
+    remove(path);
+
+    EXPECT_EQ(values, result);
+    EXPECT_THROW(Seza::MappedFileReader("missing/file.json"), Seza::MappedFileException);
+}
+
+template<typename T>
+static void checkIntegerFormat(JsonSerializer& serializer, T value)
+{
+    Seza::StringWriter writer;
+    serializer.write(writer, value);
+    EXPECT_EQ(std::to_string(value), writer.str());
+
+    std::wostringstream os;
+    serializer.write(os, value);
+    EXPECT_EQ(Seza::convertToWString(std::to_string(value)), os.str());
+}
+
+template<typename T>
+static void checkIntegerLimits(JsonSerializer& serializer)
+{
+    checkIntegerFormat<T>(serializer, std::numeric_limits<T>::min());
+    checkIntegerFormat<T>(serializer, std::numeric_limits<T>::max());
+    checkIntegerFormat<T>(serializer, 0);
+    checkIntegerFormat<T>(serializer, 9);
+    checkIntegerFormat<T>(serializer, 10);
+    checkIntegerFormat<T>(serializer, 99);
+    checkIntegerFormat<T>(serializer, 100);
+}
+
+TEST(ValueTest, IntegerJSONTest)
+{
+    JsonSerializer serializer;
+
+    checkIntegerLimits<short>(serializer);
+    checkIntegerLimits<unsigned short>(serializer);
+    checkIntegerLimits<int>(serializer);
+    checkIntegerLimits<unsigned int>(serializer);
+    checkIntegerLimits<long>(serializer);
+    checkIntegerLimits<unsigned long>(serializer);
+    checkIntegerLimits<long long>(serializer);
+    checkIntegerLimits<unsigned long long>(serializer);
+
+    unsigned long long value = 1;
+    for(int i = 0; i < 64; ++i, value = value * 3 + 1)
+    {
+        checkIntegerFormat<unsigned long long>(serializer, value);
+        checkIntegerFormat<long long>(serializer, -(long long)(value >> 1));
+    }
+}
+
+template<typename T>
+static std::string formatJSON(JsonSerializer& serializer, T value)
+{
+    Seza::StringWriter writer;
+    serializer.write(writer, value);
+    return writer.str();
+}
+
+TEST(ValueTest, FloatJSONTest)
+{
+    JsonSerializer serializer;
+
+    EXPECT_EQ("0.1", formatJSON(serializer, 0.1f));
+    EXPECT_EQ("0.1", formatJSON(serializer, 0.1));
+    EXPECT_EQ("0.1", formatJSON(serializer, (long double)0.1));
+    EXPECT_EQ("-1.5", formatJSON(serializer, -1.5));
+    EXPECT_EQ("100", formatJSON(serializer, 100.0));
+    EXPECT_EQ("0", formatJSON(serializer, 0.0));
+    EXPECT_EQ("0.0001", formatJSON(serializer, 0.0001));
+    EXPECT_EQ("1e-5", formatJSON(serializer, 0.00001));
+    EXPECT_EQ("1.7976931348623157e+308", formatJSON(serializer, std::numeric_limits<double>::max()));
+    EXPECT_EQ("5e-324", formatJSON(serializer, std::numeric_limits<double>::denorm_min()));
+    EXPECT_EQ("null", formatJSON(serializer, std::numeric_limits<double>::quiet_NaN()));
+    EXPECT_EQ("null", formatJSON(serializer, std::numeric_limits<float>::infinity()));
+
+    std::wostringstream os;
+    serializer.write(os, 2.25f);
+    EXPECT_EQ(L"2.25", os.str());
+
+    // Round trip
+    std::mt19937_64 generator(1);
+    for(int i = 0; i < 100000; ++i)
+    {
+        unsigned long long bits = generator();
+        double value;
+        float single;
+        memcpy(&value, &bits, sizeof(value));
+        memcpy(&single, &bits, sizeof(single));
+
+        if(std::isfinite(value))
+            EXPECT_EQ(value, strtod(formatJSON(serializer, value).c_str(), NULL));
+        if(std::isfinite(single))
+            EXPECT_EQ(single, strtof(formatJSON(serializer, single).c_str(), NULL));
+    }
+}
+
+template<typename T>
+T parseJSON(const std::string& json)
+{
+    JsonDeserializer deserializer;
+    std::istringstream is(json);
+    T value;
+    deserializer.read(is, value);
+    return value;
+}
+
+TEST(ValueTest, FloatParseJSONTest)
+{
+    EXPECT_EQ(0.1, parseJSON<double>("0.1"));
+    EXPECT_EQ(0.1f, parseJSON<float>(" 0.1"));
+    EXPECT_EQ(-1.5e300, parseJSON<double>("-1.5e300"));
+    EXPECT_EQ(5e-324, parseJSON<double>("4.9406564584124654e-324"));
+    EXPECT_EQ(0.0, parseJSON<double>("1e-400"));
+    EXPECT_TRUE(std::signbit(parseJSON<double>("-0")));
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), parseJSON<double>("1e400"));
+    EXPECT_EQ(9007199254740993.0, parseJSON<double>("9007199254740993"));
+    EXPECT_EQ(0.3, parseJSON<double>("0.299999999999999988897769753748434595763683319091796875"));
+    EXPECT_EQ((long double)1.25, parseJSON<long double>("1.25"));
+    EXPECT_TRUE(std::isnan(parseJSON<double>("null")));
+    EXPECT_THROW(parseJSON<double>("1."), JsonException*);
+    EXPECT_THROW(parseJSON<double>("+1"), JsonException*);
+
+    // Compared to the C library
+    std::mt19937_64 generator(2);
+    char buffer[64];
+    for(int i = 0; i < 100000; ++i)
+    {
+        unsigned long long mantissa = generator() >> (generator() % 64);
+        int exponent = (int)(generator() % 700) - 350;
+        snprintf(buffer, sizeof(buffer), "%llue%d", mantissa, exponent);
+
+        EXPECT_EQ(strtod(buffer, NULL), parseJSON<double>(buffer));
+        EXPECT_EQ(strtof(buffer, NULL), parseJSON<float>(buffer));
+    }
+}
+
+template<typename T>
+void checkIntegerParse()
+{
+    EXPECT_EQ(std::numeric_limits<T>::max(), parseJSON<T>(std::to_string(std::numeric_limits<T>::max())));
+    EXPECT_EQ(std::numeric_limits<T>::min(), parseJSON<T>(std::to_string(std::numeric_limits<T>::min())));
+    EXPECT_THROW(parseJSON<T>(std::to_string(std::numeric_limits<T>::max()) + "0"), JsonException*);
+}
+
+TEST(ValueTest, IntegerParseJSONTest)
+{
+    checkIntegerParse<short>();
+    checkIntegerParse<unsigned short>();
+    checkIntegerParse<int>();
+    checkIntegerParse<unsigned int>();
+    checkIntegerParse<long>();
+    checkIntegerParse<unsigned long>();
+    checkIntegerParse<long long>();
+    checkIntegerParse<unsigned long long>();
+
+    EXPECT_EQ(0, parseJSON<int>("0"));
+    EXPECT_EQ(0u, parseJSON<unsigned int>("-0"));
+    EXPECT_EQ(1234567890123456789LL, parseJSON<long long>(" 1234567890123456789,"));
+    EXPECT_THROW(parseJSON<short>("32768"), JsonException*);
+    EXPECT_THROW(parseJSON<unsigned int>("-1"), JsonException*);
+    EXPECT_THROW(parseJSON<unsigned long long>("18446744073709551616"), JsonException*);
+    EXPECT_THROW(parseJSON<int>("012"), JsonException*);
+    EXPECT_THROW(parseJSON<int>("+12"), JsonException*);
+    EXPECT_THROW(parseJSON<int>("1.5"), JsonException*);
+
+    std::mt19937_64 generator(3);
+    for(int i = 0; i < 100000; ++i)
+    {
+        long long value = (long long)generator() >> (generator() % 64);
+        EXPECT_EQ(value, parseJSON<long long>(std::to_string(value)));
+    }
+}
+
+TEST(StringTest, ParseJSONTest)
+{
+    EXPECT_EQ("plain", parseJSON<std::string>(" \"plain\""));
+    EXPECT_EQ("", parseJSON<std::string>("\"\""));
+    EXPECT_EQ("say \"hi\"\\", parseJSON<std::string>("\"say \\\"hi\\\"\\\\\""));
+    EXPECT_EQ("a/b\b\f\n\r\t", parseJSON<std::string>("\"a\\/b\\b\\f\\n\\r\\t\""));
+    EXPECT_EQ(std::string("\0x", 2), parseJSON<std::string>("\"\\u0000x\""));
+    EXPECT_EQ("\xC3\xB1\xE2\x82\xAC\xF0\x9F\x98\x80", parseJSON<std::string>("\"\\u00f1\\u20AC\\ud83d\\ude00\""));
+    EXPECT_EQ(L"\u00f1\u20AC", parseJSON<std::wstring>("\"\xC3\xB1\\u20AC\""));
+    EXPECT_EQ(L"\u00ff", parseJSON<std::wstring>("\"\xFF\"")); // Not UTF-8
+
+    EXPECT_THROW(parseJSON<std::string>("\"unterminated"), JsonException*);
+    EXPECT_THROW(parseJSON<std::string>("\"escaped end\\\""), JsonException*);
+    EXPECT_THROW(parseJSON<std::string>("\"bad \\x escape\""), JsonException*);
+    EXPECT_THROW(parseJSON<std::string>("\"lone \\ud83d surrogate\""), JsonException*);
+    EXPECT_THROW(parseJSON<std::string>("\"control \n character\""), JsonException*);
+
+    // Long strings go through the vectorized scanner
+    std::string text;
+    std::string json = "\"";
+    for(int i = 0; i < 1000; ++i)
+    {
+        text += "some plain text ";
+        json += "some plain text ";
+        if(i % 7 == 0)
+        {
+            text += "\"\\\n";
+            json += "\\\"\\\\\\n";
+        }
+    }
+    json += "\"";
+    EXPECT_EQ(text, parseJSON<std::string>(json));
+
+    std::wistringstream is(L"\"wide \\\"text\\\" \\u20ac\"");
+    std::wstring wide;
+    JsonDeserializer deserializer;
+    deserializer.read(is, wide);
+    EXPECT_EQ(L"wide \"text\" \u20ac", wide);
+}
+
+TEST(StringTest, StreamJSONTest)
+{
+    JsonSerializer serializer;
+
+    EXPECT_EQ("\"plain\"", formatJSON(serializer, std::string("plain")));
+    EXPECT_EQ("\"say \\\"hi\\\"\\\\\"", formatJSON(serializer, std::string("say \"hi\"\\")));
+    EXPECT_EQ("\"\\b\\f\\n\\r\\t\\u0001\\u001f\"", formatJSON(serializer, std::string("\b\f\n\r\t\x01\x1f")));
+    EXPECT_EQ(std::string("\"a\\u0000b\""), formatJSON(serializer, std::string("a\0b", 3)));
+    EXPECT_EQ("\"\xC3\xB1\xE2\x82\xAC\xF0\x9F\x98\x80\\n\"", formatJSON(serializer, std::wstring(L"ñ€\U0001F600\n")));
+
+    std::wostringstream os;
+    serializer.write(os, std::wstring(L"tab\there \"ñ\""));
+    EXPECT_EQ(L"\"tab\\there \\\"ñ\\\"\"", os.str());
+
+    // Round trip of long strings with escapes in every position
+    std::mt19937 generator(4);
+    for(int i = 0; i < 100; ++i)
+    {
+        std::string text(generator() % 300, ' ');
+        for(size_t j = 0; j < text.size(); ++j)
+            text[j] = (char)(generator() % 128);
+
+        EXPECT_EQ(text, parseJSON<std::string>(formatJSON(serializer, text)));
+    }
+}
+
+TEST(StaticTest, StreamJSONTest)
+{
+    JsonSerializer serializer;
+    Point point = { 1, -2, "origin", { 3, 4, 5 } };
+
+    // The statically dispatched path writes the same output as the virtual one
+    std::ostringstream os;
+    Seza::serialize<JsonSerializer>(os, point);
+    EXPECT_EQ(formatJSON(serializer, point), os.str());
+
+    std::map<std::string, std::vector<Point> > map;
+    map["a"].push_back(point);
+    map["b"];
+    std::string output;
+    {
+        Seza::StringWriter writer(output);
+        Seza::serialize<JsonSerializer>(writer, map);
+    }
+    EXPECT_EQ(formatJSON(serializer, map), output);
+
+    std::array<double, 3> array = {{ 0.5, -1.0, 2.25 }};
+    std::forward_list<std::string> list = { "x", "y" };
+    std::set<int> set = { 3, 1, 2 };
+    EXPECT_EQ("[0.5,-1,2.25]", formatJSON(serializer, array));
+    os.str("");
+    Seza::serialize<JsonSerializer>(os, array);
+    Seza::serialize<JsonSerializer>(os, list);
+    Seza::serialize<JsonSerializer>(os, set);
+    Seza::serialize<JsonSerializer>(os, Empty());
+    EXPECT_EQ("[0.5,-1,2.25][\"x\",\"y\"][1,2,3]{\"_className_\":\"Empty\"}", os.str());
+
+    std::wostringstream wos;
+    Seza::serialize<JsonSerializer>(wos, point);
+    EXPECT_EQ(L"{\"_className_\":\"Point\",\"x\":1,\"y\":-2,\"label\":\"origin\",\"values\":[3,4,5]}", wos.str());
+
+    // Round trip
+    Point result = { 0, 0, "", {} };
+    std::istringstream is(formatJSON(serializer, point));
+    Seza::deserialize<JsonDeserializer>(is, result);
+    EXPECT_EQ(1, result.x);
+    EXPECT_EQ(-2, result.y);
+    EXPECT_EQ("origin", result.label);
+    EXPECT_EQ(point.values, result.values);
+
+    std::map<std::string, std::vector<Point> > mapResult;
+    Seza::BufferReader reader(output.data(), output.size());
+    Seza::deserialize<JsonDeserializer>(reader, mapResult);
+    ASSERT_EQ(2u, mapResult.size());
+    ASSERT_EQ(1u, mapResult["a"].size());
+    EXPECT_EQ("origin", mapResult["a"][0].label);
+    EXPECT_TRUE(mapResult["b"].empty());
+
+    std::forward_list<std::string> listResult;
+    std::istringstream listInput("[\"x\",\"y\"]");
+    Seza::deserialize<JsonDeserializer>(listInput, listResult);
+    EXPECT_EQ(list, listResult);
+
+    std::istringstream unknown("{\"_className_\":\"Point\",\"z\":1}");
+    EXPECT_ANY_THROW(Seza::deserialize<JsonDeserializer>(unknown, result));
+}
+
+#if __cplusplus >= 201703L
+TEST(ReaderTest, MemoryResourceJSONTest)
+{
+    Message message;
+    message.name = "a name longer than the small string buffer";
+    message.tags = { "the first tag, long enough to be allocated", "second" };
+    message.counts["a key longer than the small string buffer"] = { 1, 2, 3 };
+    message.counts["b"];
+    JsonSerializer serializer;
+    std::string input = formatJSON(serializer, message);
+
+    // Any allocation outside the arena throws
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+    Seza::BufferReader reader(input.data(), input.size());
+    Message result = Seza::deserialize<JsonDeserializer, Message>(reader, &arena);
+    JsonDeserializer deserializer;
+    deserializer.setMemoryResource(&arena);
+    Seza::BufferReader again(input.data(), input.size());
+    Message other = deserializer.make<Message>(again);
+
+    std::pmr::set_default_resource(previous);
+
+    EXPECT_EQ(input, formatJSON(serializer, result));
+    EXPECT_EQ(input, formatJSON(serializer, other));
+    EXPECT_EQ(&arena, result.name.get_allocator().resource());
+    EXPECT_EQ(&arena, result.tags.front().get_allocator().resource());
+    EXPECT_EQ(&arena, result.counts.begin()->first.get_allocator().resource());
+    EXPECT_EQ(&arena, result.counts.begin()->second.get_allocator().resource());
+    EXPECT_EQ(&arena, other.tags.back().get_allocator().resource());
+}
+
+TEST(ReaderTest, StringPoolJSONTest)
+{
+    const char* statuses[] = { "ok", "a status longer than the small string buffer", "failed" };
+    std::vector<std::string> hosts;
+    for(int i = 0; i < 4; ++i)
+        hosts.push_back("host-" + std::to_string(i) + ".example.com");
+
+    std::vector<Record> records(100);
+    for(size_t i = 0; i < records.size(); ++i)
+    {
+        records[i].status = statuses[i % 3];
+        records[i].host = hosts[i % 4];
+        records[i].metrics["latency"] = (int)i;
+        records[i].metrics["requests"] = 1;
+    }
+    JsonSerializer serializer;
+    std::string input = formatJSON(serializer, records);
+
+    JsonDeserializer deserializer;
+    std::vector<Record> result;
+    Seza::BufferReader reader(input.data(), input.size());
+    EXPECT_ANY_THROW(deserializer.read(reader, result));
+
+    Seza::StringPool pool;
+    deserializer.setStringPool(&pool);
+    result.clear();
+    Seza::BufferReader again(input.data(), input.size());
+    deserializer.read(again, result);
+
+    EXPECT_EQ(input, formatJSON(serializer, result));
+    EXPECT_EQ(9u, pool.size());
+    EXPECT_EQ(400u - 9u, pool.hits());
+    EXPECT_DOUBLE_EQ((400.0 - 9.0) / 400.0, pool.hitRate());
+    EXPECT_EQ(result[1].status.data(), result[4].status.data());
+    EXPECT_EQ(result[0].metrics.begin()->first.data(), result[99].metrics.begin()->first.data());
+
+    // The static path interns too, and wide views are interned apart
+    std::vector<Record> other;
+    Seza::BufferReader third(input.data(), input.size());
+    deserializer.readStatic(third, other);
+    EXPECT_EQ(input, formatJSON(serializer, other));
+
+    std::wstring_view wide;
+    std::istringstream wideInput("\"ok\"");
+    deserializer.read(wideInput, wide);
+    EXPECT_EQ(L"ok", wide);
+    EXPECT_EQ(10u, pool.size());
+}
+#endif
+
+TEST(ReaderTest, PushParserJSONTest)
+{
+    std::map<std::string, std::vector<Point> > map;
+    for(int i = 0; i < 20; ++i)
+    {
+        Point point = { i * 12345, -i, "a \"label\" with escapes \\ and \u00e9 " + std::to_string(i), { i, -i * 1000, 7 } };
+        map["key " + std::to_string(i % 5)].push_back(point);
+    }
+    JsonSerializer serializer;
+    std::string input = formatJSON(serializer, map);
+
+    // Chunks break the strings, numbers and names anywhere
+    size_t chunks[] = { 1, 3, 64, input.size() };
+    for(size_t chunk : chunks)
+    {
+        std::map<std::string, std::vector<Point> > result;
+        JsonDeserializer deserializer;
+        Seza::PushParser parser(deserializer, result);
+        bool done = false;
+        for(size_t i = 0; i < input.size(); i += chunk)
+        {
+            EXPECT_FALSE(done);
+            std::string piece = input.substr(i, chunk); // Not used after feed
+            done = parser.feed(piece);
+        }
+        EXPECT_TRUE(done);
+        parser.finish();
+        EXPECT_EQ(input, formatJSON(serializer, result));
+    }
+
+    // Numbers may continue until the input finishes
+    int number = 0;
+    JsonDeserializer deserializer;
+    Seza::PushParser numbers(deserializer, number);
+    EXPECT_FALSE(numbers.feed("-12"));
+    EXPECT_FALSE(numbers.feed("34"));
+    numbers.finish();
+    EXPECT_TRUE(numbers.done());
+    EXPECT_EQ(-1234, number);
+
+    // Truncated input throws, and abandoned parsers unwind their pending objects
+    std::string half = input.substr(0, input.size() / 2);
+    std::map<std::string, std::vector<Point> > truncated;
+    Seza::PushParser parser(deserializer, truncated);
+    EXPECT_FALSE(parser.feed(half));
+    EXPECT_ANY_THROW(parser.finish());
+    EXPECT_ANY_THROW(parser.feed(half));
+
+    std::map<std::string, std::vector<Point> > abandoned;
+    {
+        Seza::PushParser other(deserializer, abandoned);
+        EXPECT_FALSE(other.feed(half));
+    }
+    EXPECT_FALSE(abandoned.empty());
+}
+
+#if defined(SEZA_HAS_UCONTEXT)
+TEST(ReaderTest, PushParserStackJSONTest)
+{
+    std::string input;
+    for(int i = 0; i < 100000; ++i)
+        input += "{\"_className_\":\"Tree\",\"children\":[";
+
+    // Input nested deeper than the stack throws, and the parser can read again after a reset
+    Tree tree;
+    JsonDeserializer deserializer;
+    Seza::PushParser parser(deserializer, tree, 1 << 16);
+    EXPECT_THROW(parser.feed(input), Seza::PushParserException);
+    EXPECT_THROW(parser.feed(input), Seza::PushParserDepthException);
+
+    tree.children.clear();
+    parser.reset();
+    EXPECT_FALSE(parser.feed("{\"_className_\":\"Tree\",\"children\":[{\"_className_\":"));
+    EXPECT_TRUE(parser.feed("\"Tree\",\"children\":[]}]}"));
+    parser.finish();
+    EXPECT_EQ(1u, tree.children.size());
+
+    // The deserializer is not limited outside the parser
+    std::string leaf = "{\"_className_\":\"Tree\",\"children\":[]}";
+    Tree shallow;
+    Seza::BufferReader reader(leaf);
+    deserializer.read(reader, shallow);
+    EXPECT_TRUE(shallow.children.empty());
+
+    // Default stacks hold deep input
+    std::string deep;
+    for(int i = 0; i < 100; ++i)
+        deep += "{\"_className_\":\"Tree\",\"children\":[";
+    deep += leaf;
+    for(int i = 0; i < 100; ++i)
+        deep += "]}";
+    Tree deepTree;
+    Seza::PushParser deepParser(deserializer, deepTree);
+    EXPECT_TRUE(deepParser.feed(deep));
+}
+#endif
+
+TEST(WriterTest, RangeJSONTest)
+{
+    std::vector<Point> points;
+    for(int i = 0; i < 100; ++i)
+    {
+        Point point = { i, -i, "point " + std::to_string(i), { i, i + 1 } };
+        points.push_back(point);
+    }
+    std::vector<std::vector<int> > nested = { { 1, 2 }, {}, { 3 } };
+    JsonSerializer serializer;
+    std::string expected = formatJSON(serializer, points);
+
+    // Ranges of containers and iterators
+    EXPECT_EQ(expected, formatJSON(serializer, Seza::makeRange(points)));
+    EXPECT_EQ("[[1,2],[],[3]]", formatJSON(serializer, Seza::makeRange(nested)));
+    EXPECT_EQ("[[1,2],[]]", formatJSON(serializer, Seza::makeRange(nested.begin(), nested.begin() + 2)));
+    std::istringstream numbers("1 2 3");
+    EXPECT_EQ("[1,2,3]", formatJSON(serializer, Seza::makeRange(std::istream_iterator<int>(numbers), std::istream_iterator<int>())));
+
+    // Generators reuse a single element
+    size_t next = 0;
+    std::set<const Point*> elements;
+    auto generator = [&](Point& point) 
+    {
+        if(next == points.size())
+            return false;
+        elements.insert(&point);
+        point = points[next++];
+        return true;
+    };
+    std::ostringstream os;
+    serializer.write(os, Seza::makeGenerator<Point>(generator));
+    EXPECT_EQ(expected, os.str());
+    EXPECT_EQ(1u, elements.size());
+
+    next = 0;
+    os.str("");
+    Seza::serialize<JsonSerializer>(os, Seza::makeGenerator<Point>(generator));
+    EXPECT_EQ(expected, os.str());
+    os.str("");
+    Seza::serialize<JsonSerializer>(os, Seza::makeRange(points));
+    EXPECT_EQ(expected, os.str());
+
+    // Ranges are only written
+    Seza::SerializableRange<std::vector<Point>::const_iterator> range = Seza::makeRange(points);
+    JsonDeserializer deserializer;
+    Seza::BufferReader reader(expected);
+    EXPECT_THROW(deserializer.read(reader, (Seza::SerializableSTLContainer&) range), Seza::WriteOnlyException);
+}
+
+TEST(LinesTest, BatchJSONTest)
+{
+    std::vector<Point> points;
+    for(int i = 0; i < 5000; ++i)
+    {
+        Point point = { i, -i, "point " + std::to_string(i), std::vector<int>(i % 4, i) };
+        points.push_back(point);
+    }
+
+    // Lines are written in order whatever the threads
+    JsonSerializer serializer;
+    std::string expected;
+    for(size_t i = 0; i < points.size(); ++i)
+        expected += formatJSON(serializer, points[i]) + "\n";
+    std::string output;
+    JSON::writeLines(output, points, 4);
+    EXPECT_EQ(expected, output);
+    std::string single;
+    JSON::writeLines(single, points, 1);
+    EXPECT_EQ(expected, single);
+
+    std::vector<Point> result;
+    EXPECT_TRUE(JSON::readLines(output, result, 4).empty());
+    std::string again;
+    JSON::writeLines(again, result);
+    EXPECT_EQ(expected, again);
+
+    // A failed write wakes the threads waiting for the lines before theirs
+    std::vector<char> small(expected.size() / 2);
+    Seza::BufferWriter smallWriter(&small[0], small.size());
+    EXPECT_THROW(JSON::writeLines(smallWriter, points, 2), Seza::WriterOverflowException);
+
+    // Errors are reported by line, and the other lines are read in order
+    std::string input = output.substr(0, output.find('\n') + 1);
+    input += "\r\n";
+    input += "{\"_className_\":\"Point\",\"x\":\n";
+    input += "  \n";
+    input += formatJSON(serializer, points[1]) + "\r\n";
+    input += formatJSON(serializer, points[2]) + " garbage\n";
+    input += formatJSON(serializer, points[3]);
+    result.clear();
+    std::vector<JSON::LineError> errors = JSON::readLines(input, result, 3);
+    ASSERT_EQ(2u, errors.size());
+    EXPECT_EQ(3u, errors[0].line);
+    EXPECT_EQ(6u, errors[1].line);
+    EXPECT_FALSE(errors[1].message.empty());
+    ASSERT_EQ(3u, result.size());
+    EXPECT_EQ(0, result[0].x);
+    EXPECT_EQ(1, result[1].x);
+    EXPECT_EQ(3, result[2].x);
+
+    // Errors are numbered across the bytes read by each thread
+    std::string broken;
+    for(size_t i = 0; i < points.size(); ++i)
+        broken += ((i == 999) || (i == 3999)) ? std::string("[\n") : formatJSON(serializer, points[i]) + "\n";
+    ASSERT_LT(3 * JSON::bytesPerTask, broken.size());
+    result.clear();
+    errors = JSON::readLines(broken, result, 4);
+    ASSERT_EQ(2u, errors.size());
+    EXPECT_EQ(1000u, errors[0].line);
+    EXPECT_EQ(4000u, errors[1].line);
+    ASSERT_EQ(points.size() - 2, result.size());
+    EXPECT_EQ(998, result[998].x);
+    EXPECT_EQ(1000, result[999].x);
+    EXPECT_EQ(4999, result.back().x);
+
+    // Mapped files
+    const char* path = "testLines.jsonl";
+    {
+        std::ofstream os(path);
+        os << output;
+    }
+    result.clear();
+    {
+        Seza::MappedFileReader reader(path);
+        EXPECT_TRUE(JSON::readLines(reader, result).empty());
+    }
+    remove(path);
+    EXPECT_EQ(points.size(), result.size());
+    EXPECT_EQ(points.back().label, result.back().label);
+}
+
 int main(int argc, char **argv) 
 {
     ::testing::InitGoogleTest( &argc, argv );
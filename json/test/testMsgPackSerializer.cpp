@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include <MsgPackSerializer.h>
+#include <MsgPackDeserializer.h>
+
+typedef std::map<std::string, int> Counters;
+
+struct Message
+{
+    int id;
+    std::string text;
+    std::vector<double> values;
+    Counters counters;
+};
+
+namespace Seza
+{
+    REGISTER_SERIALIZABLE(Message, ADD_MEMBER(id, int) ADD_MEMBER(text, std::string) 
+        ADD_MEMBER(values, std::vector<double>) ADD_MEMBER(counters, Counters))
+}
+
+template<typename T>
+std::string writeMsgPack(T value)
+{
+    MsgPackSerializer serializer;
+    Seza::StringWriter writer;
+    serializer.write(writer, value);
+    return writer.str();
+}
+
+template<typename T>
+T readMsgPack(const std::string& data)
+{
+    MsgPackDeserializer deserializer;
+    Seza::BufferReader reader(data);
+    T value = T();
+    deserializer.read(reader, value);
+    EXPECT_EQ(0u, reader.available());
+    return value;
+}
+
+TEST(ValueTest, MsgPackTest)
+{
+    // Smallest encodings
+    EXPECT_EQ(std::string("\x05", 1), writeMsgPack(5));
+    EXPECT_EQ(std::string("\xFF", 1), writeMsgPack(-1));
+    EXPECT_EQ(std::string("\xCC\xC8", 2), writeMsgPack(200));
+    EXPECT_EQ(std::string("\xD0\x9C", 2), writeMsgPack((short)-100));
+    EXPECT_EQ(std::string("\xCD\x01\x00", 3), writeMsgPack(256LL));
+    EXPECT_EQ(std::string("\xD2\x80\x00\x00\x00", 5), writeMsgPack(std::numeric_limits<int>::min()));
+    EXPECT_EQ(std::string("\xCF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 9), writeMsgPack(std::numeric_limits<unsigned long long>::max()));
+    EXPECT_EQ(std::string("\xC3", 1), writeMsgPack(true));
+    EXPECT_EQ(std::string("\xCB\x3F\xF8\x00\x00\x00\x00\x00\x00", 9), writeMsgPack(1.5));
+    EXPECT_EQ(std::string("\xCA\x3F\xC0\x00\x00", 5), writeMsgPack(1.5f));
+
+    EXPECT_EQ(-1234567890123LL, readMsgPack<long long>(writeMsgPack(-1234567890123LL)));
+    EXPECT_EQ(std::numeric_limits<unsigned long long>::max(), 
+        readMsgPack<unsigned long long>(writeMsgPack(std::numeric_limits<unsigned long long>::max())));
+    EXPECT_EQ(0.1, readMsgPack<double>(writeMsgPack(0.1)));
+    EXPECT_EQ(false, readMsgPack<bool>(writeMsgPack(false)));
+
+    // Any format that fits
+    EXPECT_EQ(7, readMsgPack<int>(std::string("\xD3\x00\x00\x00\x00\x00\x00\x00\x07", 9)));
+    EXPECT_EQ(3.0, readMsgPack<double>(std::string("\x03", 1)));
+    EXPECT_EQ(1.5, readMsgPack<double>(writeMsgPack(1.5f)));
+    EXPECT_THROW(readMsgPack<unsigned int>(writeMsgPack(-1)), MsgPack::MsgPackException*);
+    EXPECT_THROW(readMsgPack<char>(writeMsgPack(200)), MsgPack::MsgPackException*);
+    EXPECT_THROW(readMsgPack<int>(writeMsgPack(1.5)), MsgPack::MsgPackException*);
+    EXPECT_THROW(readMsgPack<int>(std::string("\xCD\x01", 2)), MsgPack::MsgPackException*);
+}
+
+/** Reader that delivers its input in blocks of 4 bytes and records the largest contiguous size 
+required from it **/
+class ChunkReader : public Seza::Reader
+{
+public:
+    ChunkReader(const std::string& data) : _data(data), _position(0), _largest(0) {}
+
+    size_t largest() const { return _largest; }
+
+protected:
+    virtual bool underflow()
+    {
+        _block.clear();
+        return next();
+    }
+
+    virtual bool refill(size_t size)
+    {
+        _largest = std::max(_largest, size);
+        _block.assign(_cursor, _end);
+        while(_block.size() < size)
+        {
+            if(!next())
+                return false;
+        }
+        return true;
+    }
+
+    bool next()
+    {
+        if(_position == _data.size())
+            return false;
+        size_t size = std::min<size_t>(4, _data.size() - _position);
+        _block.append(_data, _position, size);
+        _position += size;
+        _cursor = _block.data();
+        _end = _cursor + _block.size();
+        return true;
+    }
+
+    std::string _data;
+    std::string _block;
+    size_t _position;
+    size_t _largest;
+};
+
+TEST(StringTest, MsgPackTest)
+{
+    EXPECT_EQ(std::string("\xA3" "abc", 4), writeMsgPack(std::string("abc")));
+    EXPECT_EQ(std::string("\xD9\x20", 2), writeMsgPack(std::string(32, 'x')).substr(0, 2));
+    EXPECT_EQ(std::string("\xDA\x01\x00", 3), writeMsgPack(std::string(256, 'x')).substr(0, 3));
+
+    std::string text("a\0b", 3);
+    EXPECT_EQ(text, readMsgPack<std::string>(writeMsgPack(text)));
+    EXPECT_EQ(std::string(70000, 'y'), readMsgPack<std::string>(writeMsgPack(std::string(70000, 'y'))));
+
+    std::wstring wide(L"é中");
+    EXPECT_EQ(std::string("\xA5\xC3\xA9\xE4\xB8\xAD", 6), writeMsgPack(wide));
+    EXPECT_EQ(wide, readMsgPack<std::wstring>(writeMsgPack(wide)));
+
+    // Strings are read a buffer at a time, the sizes are not trusted
+    MsgPackDeserializer deserializer;
+    ChunkReader chunks(writeMsgPack(std::string(70000, 'y')));
+    deserializer.read(chunks, text);
+    EXPECT_EQ(std::string(70000, 'y'), text);
+    EXPECT_GE(4u, chunks.largest());
+
+    ChunkReader huge(std::string("\xDB\xFF\xFF\xFF\xFF" "abc", 8));
+    EXPECT_THROW(deserializer.read(huge, text), MsgPack::MsgPackException*);
+    EXPECT_GE(4u, huge.largest());
+}
+
+TEST(ContainerTest, MsgPackTest)
+{
+    std::vector<int> values = { 1, -2, 300 };
+    EXPECT_EQ(std::string("\x93\x01\xFE\xCD\x01\x2C", 6), writeMsgPack(values));
+    EXPECT_EQ(values, readMsgPack<std::vector<int> >(writeMsgPack(values)));
+
+    Counters counters;
+    counters["a"] = 1;
+    counters["b"] = 2;
+    EXPECT_EQ(std::string("\x82\xA1" "a" "\x01\xA1" "b" "\x02", 7), writeMsgPack(counters));
+    EXPECT_TRUE(counters == readMsgPack<Counters>(writeMsgPack(counters)));
+    EXPECT_TRUE(counters == readMsgPack<Counters>(std::string("\x92\x92\xA1" "a" "\x01\x92\xA1" "b" "\x02", 9)));
+
+    std::map<int, std::vector<std::string> > nested;
+    nested[1].push_back("x");
+    nested[2];
+    EXPECT_TRUE(nested == (readMsgPack<std::map<int, std::vector<std::string> > >(writeMsgPack(nested))));
+
+    std::vector<int> large(20, 1);
+    EXPECT_EQ(std::string("\xDC\x00\x14", 3), writeMsgPack(large).substr(0, 3));
+    EXPECT_EQ(large, readMsgPack<std::vector<int> >(writeMsgPack(large)));
+}
+
+TEST(SerializableTest, MsgPackTest)
+{
+    Message message;
+    message.id = 7;
+    message.text = "hello";
+    message.values.push_back(0.5);
+    message.counters["n"] = -3;
+
+    std::string data = writeMsgPack(message);
+    EXPECT_EQ(std::string("\x85\xAB_className_\xA7Message\xA2id\x07", 25), data.substr(0, 25));
+
+    Message copy = readMsgPack<Message>(data);
+    EXPECT_EQ(message.id, copy.id);
+    EXPECT_EQ(message.text, copy.text);
+    EXPECT_EQ(message.values, copy.values);
+    EXPECT_TRUE(message.counters == copy.counters);
+
+    // Maps from other components, in any order and without a class name
+    Message other = readMsgPack<Message>(std::string("\x82\xA4text\xA2hi\xA2id\xCC\xC8", 14));
+    EXPECT_EQ(200, other.id);
+    EXPECT_EQ("hi", other.text);
+
+    EXPECT_THROW(readMsgPack<Message>(std::string("\x81\xA7unknown\x01", 10)), MsgPack::MsgPackException*);
+    EXPECT_THROW(readMsgPack<Message>(std::string("\x81\xAB_className_\xA5Other", 19)), MsgPack::MsgPackException*);
+
+    // Names split across buffers, only the class name key is required whole
+    MsgPackDeserializer deserializer;
+    ChunkReader chunks(data);
+    Message split;
+    deserializer.read(chunks, split);
+    EXPECT_EQ(message.text, split.text);
+    EXPECT_TRUE(message.counters == split.counters);
+    EXPECT_GE(12u, chunks.largest());
+
+    ChunkReader huge(std::string("\x81\xDB\xFF\xFF\xFF\xFF" "id", 8));
+    EXPECT_THROW(deserializer.read(huge, split), MsgPack::MsgPackException*);
+    EXPECT_GE(12u, huge.largest());
+
+    // Stream adapters
+    MsgPackSerializer serializer;
+    std::ostringstream os;
+    serializer.write(os, message);
+    EXPECT_EQ(data, os.str());
+}